@@ -0,0 +1,116 @@
+#include "smash_audio.h"
+
+bool LoadGameSound(SoundMixer *mixer, GameSound sound, const char *fileName, int voices, int priority, float coalesceTime) {
+    SoundVoices *entry = &mixer->sounds[sound];
+    *entry = (SoundVoices){ 0 };
+    entry->priority = priority;
+    entry->coalesceTime = coalesceTime;
+    entry->lastStart = -1e9;
+
+    entry->voices[0] = LoadSound(fileName);
+    if (!IsSoundReady(entry->voices[0])) return false;
+    entry->count = 1;
+    if (voices > SOUND_MAX_VOICES) voices = SOUND_MAX_VOICES;
+    while (entry->count < voices) {
+        Sound alias = LoadSoundAlias(entry->voices[0]);
+        if (!IsSoundReady(alias)) break;
+        entry->voices[entry->count++] = alias;
+    }
+    return true;
+}
+
+// Repeats within a frame merge here, so a flood of hits can't crowd out other sounds
+void QueueSound(SoundMixer *mixer, GameSound sound) {
+    mixer->pending[sound]++;
+}
+
+// Longest-playing voice of any sound with at most this priority, or NULL
+static SoundVoices *FindVoiceToSteal(SoundMixer *mixer, int priority, int *voice) {
+    SoundVoices *oldest = NULL;
+    for (int s = 0; s < SOUND_COUNT; s++) {
+        SoundVoices *entry = &mixer->sounds[s];
+        if (entry->priority > priority) continue;
+        for (int v = 0; v < entry->count; v++) {
+            if (!IsSoundPlaying(entry->voices[v])) continue;
+            if (oldest == NULL || entry->started[v] < oldest->started[*voice]) {
+                oldest = entry;
+                *voice = v;
+            }
+        }
+    }
+    return oldest;
+}
+
+void PlayQueuedSounds(SoundMixer *mixer, double now) {
+    int playing = 0;
+    for (int s = 0; s < SOUND_COUNT; s++) {
+        for (int v = 0; v < mixer->sounds[s].count; v++) {
+            if (IsSoundPlaying(mixer->sounds[s].voices[v])) playing++;
+        }
+    }
+
+    // Highest priority first, so the budget goes to what matters most
+    bool done[SOUND_COUNT] = { false };
+    for (;;) {
+        int next = -1;
+        for (int s = 0; s < SOUND_COUNT; s++) {
+            if (done[s] || mixer->pending[s] == 0) continue;
+            if (next < 0 || mixer->sounds[s].priority > mixer->sounds[next].priority) next = s;
+        }
+        if (next < 0) break;
+        done[next] = true;
+
+        SoundVoices *entry = &mixer->sounds[next];
+        mixer->coalesced += mixer->pending[next] - 1;
+        mixer->pending[next] = 0;
+        if (entry->count == 0) continue;
+        if (now - entry->lastStart < entry->coalesceTime) {
+            mixer->coalesced++;
+            continue;
+        }
+
+        // A free voice of this sound, else its oldest
+        int voice = -1;
+        int oldest = 0;
+        for (int v = 0; v < entry->count; v++) {
+            if (!IsSoundPlaying(entry->voices[v])) {
+                voice = v;
+                break;
+            }
+            if (entry->started[v] < entry->started[oldest]) oldest = v;
+        }
+
+        if (voice < 0) {
+            // Restarting one of its own voices keeps the number playing the same
+            voice = oldest;
+            StopSound(entry->voices[voice]);
+            mixer->stolen++;
+        } else if (playing >= SOUND_VOICE_BUDGET) {
+            // Over budget: silence the oldest voice this sound outranks or matches
+            int stealVoice = 0;
+            SoundVoices *victim = FindVoiceToSteal(mixer, entry->priority, &stealVoice);
+            if (victim == NULL) {
+                mixer->dropped++;
+                continue;
+            }
+            StopSound(victim->voices[stealVoice]);
+            mixer->stolen++;
+        } else {
+            playing++;
+            mixer->played++;
+        }
+
+        PlaySound(entry->voices[voice]);
+        entry->started[voice] = now;
+        entry->lastStart = now;
+    }
+}
+
+void UnloadSoundMixer(SoundMixer *mixer) {
+    for (int s = 0; s < SOUND_COUNT; s++) {
+        SoundVoices *entry = &mixer->sounds[s];
+        for (int v = 1; v < entry->count; v++) UnloadSoundAlias(entry->voices[v]);
+        if (entry->count > 0) UnloadSound(entry->voices[0]);
+    }
+    *mixer = (SoundMixer){ 0 };
+}
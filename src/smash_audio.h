@@ -0,0 +1,48 @@
+// Smash Out! sound mixer: gameplay sounds queued as per-sound counts and started once
+// per frame from a few voices per sound (raylib aliases) within a global voice budget.
+
+#ifndef SMASH_AUDIO_H
+#define SMASH_AUDIO_H
+
+#include <stdbool.h>
+#include <raylib.h>
+
+typedef enum GameSound {
+    SOUND_BRICK_HIT,
+    SOUND_WALL_HIT,
+    SOUND_PADDLE_HIT,
+    SOUND_LOSE_HEART,
+    SOUND_GAME_OVER,
+    SOUND_COUNT
+} GameSound;
+
+#define SOUND_MAX_VOICES 4        // Voices per sound: the sound and its aliases
+#define SOUND_VOICE_BUDGET 10     // Voices playing at once, all sounds together
+
+typedef struct SoundVoices {
+    Sound voices[SOUND_MAX_VOICES];
+    double started[SOUND_MAX_VOICES];  // When each voice last started
+    int count;           // Voices loaded, 0 if the sound failed to load
+    int priority;        // Higher takes the budget from lower
+    float coalesceTime;  // Seconds after a start that repeats are merged into it
+    double lastStart;
+} SoundVoices;
+
+typedef struct SoundMixer {
+    SoundVoices sounds[SOUND_COUNT];
+    int pending[SOUND_COUNT];  // Times each sound was queued since the last drain
+    // Events since the mixer was loaded, by outcome (stats)
+    int played;
+    int coalesced;
+    int stolen;     // Played by restarting a busy voice
+    int dropped;    // No voice the budget allowed
+} SoundMixer;
+
+// voices is capped at SOUND_MAX_VOICES; false if the file couldn't be loaded (the
+// sound is then silent). Extra aliases that fail to load just mean fewer voices.
+bool LoadGameSound(SoundMixer *mixer, GameSound sound, const char *fileName, int voices, int priority, float coalesceTime);
+void QueueSound(SoundMixer *mixer, GameSound sound);
+void PlayQueuedSounds(SoundMixer *mixer, double now);  // Once per frame, highest priority first; now = GetTime()
+void UnloadSoundMixer(SoundMixer *mixer);
+
+#endif // SMASH_AUDIO_H
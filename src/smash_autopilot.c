@@ -0,0 +1,167 @@
+#include <math.h>
+#include "smash_autopilot.h"
+
+#define AUTOPILOT_MAX_HIT 0.45f  // Furthest from the paddle centre (fraction of its width) it aims to hit
+
+// No ball can reach the paddle line sooner than this, whatever it bounces off. A rising
+// ball below the board has to climb to the board's bottom edge before it can turn.
+static float GetLandingBound(const SimState *sim, const Ball *ball) {
+    if (ball->speed.y == 0.0f) return INFINITY;
+    float lineY = sim->paddle.y - ball->radius;
+    float turnY = ball->position.y;
+    if (ball->speed.y < 0.0f) {
+        const BoardLayout *layout = &sim->bricks.layout;
+        float boardBottom = (layout->rows > 0) ? layout->top + (layout->rows - 1) * layout->pitchY + layout->brickHeight : 0.0f;
+        if (turnY > boardBottom + ball->radius) turnY = boardBottom + ball->radius;
+    }
+    return (fabsf(ball->position.y - turnY) + fabsf(lineY - turnY)) / fabsf(ball->speed.y);
+}
+
+// Seconds the paddle needs to move its centre to x
+static float GetTravelTime(const SimState *sim, float x) {
+    return fabsf(x - (sim->paddle.x + sim->paddle.width / 2.0f)) / PADDLE_SPEED;
+}
+
+// Seconds the paddle needs to get a landing at x under any part of it
+static float GetReachTime(const SimState *sim, float x) {
+    float gap = fabsf(x - (sim->paddle.x + sim->paddle.width / 2.0f)) - sim->paddle.width / 2.0f;
+    return (gap > 0.0f) ? gap / PADDLE_SPEED : 0.0f;
+}
+
+// Whether a row has no live bricks, tested up to 32 bricks at a time from the mask
+static bool IsRowEmpty(const BrickField *bricks, int row) {
+    int end = (row + 1) * bricks->layout.cols;
+    for (int i = row * bricks->layout.cols; i < end;) {
+        int n = 32 - (i & 31);
+        if (n > end - i) n = end - i;
+        uint32_t bits = bricks->activeMask[i >> 5] >> (i & 31);
+        if (n < 32) bits &= (1u << n) - 1u;
+        if (bits != 0) return false;
+        i += n;
+    }
+    return true;
+}
+
+// Lowest live brick, nearest to x within its row: the one a return shot reaches first.
+// Empty rows are skipped a mask word at a time, and the lowest live row is searched
+// outward from the column under x.
+static int FindTargetBrick(const BrickField *bricks, float x) {
+    const BoardLayout *layout = &bricks->layout;
+    if (layout->cols <= 0) return -1;
+    int nearest = (int)floorf((x - layout->left - layout->brickWidth / 2.0f) / layout->pitchX + 0.5f);
+    if (nearest < 0) nearest = 0;
+    if (nearest > layout->cols - 1) nearest = layout->cols - 1;
+
+    for (int row = layout->rows - 1; row >= 0; row--) {
+        if (IsRowEmpty(bricks, row)) continue;
+        // Columns step away from the nearest one, so the first step with a live brick holds the closest
+        for (int step = 0;; step++) {
+            int best = -1;
+            float bestDistance = INFINITY;
+            for (int col = nearest - step; col <= nearest + step; col += (step > 0) ? 2 * step : 1) {
+                if (col < 0 || col >= layout->cols) continue;
+                int i = row * layout->cols + col;
+                if (!IsBrickActive(bricks, i)) continue;
+                float distance = fabsf(layout->left + col * layout->pitchX + layout->brickWidth / 2.0f - x);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = i;
+                }
+            }
+            if (best >= 0) return best;
+        }
+    }
+    return -1;
+}
+
+// Paddle centre that returns a ball landing at landing.x toward the target brick. The
+// simulation sets the bounce's speed.x from where the ball meets the paddle:
+// (offset / width) * 2 * BALL_BASE_SPEED, with offset the distance right of centre.
+static float GetAimedPaddleX(const SimState *sim, const Ball *ball, const BallLanding *landing, int brick) {
+    if (brick < 0) return landing->x;
+    SimRect rect = GetBrickRect(&sim->bricks, brick);
+    float rise = (sim->paddle.y - ball->radius) - (rect.y + rect.height + ball->radius);
+    if (rise <= 0.0f) return landing->x;
+
+    float speedX = (rect.x + rect.width / 2.0f - landing->x) * fabsf(ball->speed.y) / rise;
+    float offset = speedX / (2.0f * BALL_BASE_SPEED);
+    if (offset > AUTOPILOT_MAX_HIT) offset = AUTOPILOT_MAX_HIT;
+    if (offset < -AUTOPILOT_MAX_HIT) offset = -AUTOPILOT_MAX_HIT;
+    return landing->x - offset * sim->paddle.width;
+}
+
+void ResetAutopilot(Autopilot *pilot) {
+    pilot->targetX = SIM_SCREEN_WIDTH / 2.0f;
+    pilot->trackedBall = -1;
+    pilot->landing = (BallLanding){ 0 };
+    pilot->predictions = 0;
+    pilot->targetBrick = -1;
+}
+
+SimInput GetAutopilotInput(Autopilot *pilot, const SimState *sim) {
+    int best = -1;
+    BallLanding bestLanding = { 0 };
+    int unreachable = -1;  // Earliest landing the paddle can't make, if nothing else lands
+    BallLanding unreachableLanding = { 0 };
+    pilot->predictions = 0;
+
+    // Trace the ball with the smallest bound first, so its landing prunes the rest
+    int first = -1;
+    float firstBound = INFINITY;
+    for (int b = 0; b < sim->ballCount; b++) {
+        float bound = GetLandingBound(sim, &sim->balls[b]);
+        if (bound < firstBound) {
+            firstBound = bound;
+            first = b;
+        }
+    }
+
+    float horizon = AUTOPILOT_HORIZON;
+    for (int n = -1; n < sim->ballCount; n++) {
+        int b = (n < 0) ? first : n;
+        if (b < 0 || (n >= 0 && b == first)) continue;
+        if (GetLandingBound(sim, &sim->balls[b]) >= horizon) continue;
+
+        BallLanding landing;
+        pilot->predictions++;
+        if (!PredictBallLanding(sim, &sim->balls[b], horizon, &landing)) continue;
+        if (GetReachTime(sim, landing.x) <= landing.time) {
+            best = b;
+            bestLanding = landing;
+            horizon = landing.time;
+        } else if (unreachable < 0 || landing.time < unreachableLanding.time) {
+            unreachable = b;
+            unreachableLanding = landing;
+        }
+    }
+
+    if (best < 0 && unreachable >= 0) {
+        // Nothing can be saved in time; chase the first one down anyway
+        best = unreachable;
+        bestLanding = unreachableLanding;
+    }
+
+    pilot->trackedBall = best;
+    if (best >= 0) {
+        pilot->landing = bestLanding;
+        pilot->targetX = bestLanding.x;
+
+        // Aim the return shot when there is time to get into position
+        const BrickField *bricks = &sim->bricks;
+        if (pilot->targetBrick < 0 || pilot->targetBrick >= bricks->count || !IsBrickActive(bricks, pilot->targetBrick)) {
+            pilot->targetBrick = FindTargetBrick(bricks, bestLanding.x);
+        }
+        float aimedX = GetAimedPaddleX(sim, &sim->balls[best], &bestLanding, pilot->targetBrick);
+        if (GetTravelTime(sim, aimedX) <= bestLanding.time) pilot->targetX = aimedX;
+    } else if (first >= 0) {
+        // Nothing lands within the horizon: shadow the ball that could come down first
+        pilot->targetX = sim->balls[first].position.x;
+    }
+
+    SimInput input = { 0 };
+    float paddleCenter = sim->paddle.x + sim->paddle.width / 2.0f;
+    float deadZone = PADDLE_SPEED * SIM_DT;  // One tick of movement, so the paddle doesn't jitter
+    if (pilot->targetX < paddleCenter - deadZone) input.buttons |= SIM_INPUT_LEFT;
+    if (pilot->targetX > paddleCenter + deadZone) input.buttons |= SIM_INPUT_RIGHT;
+    return input;
+}
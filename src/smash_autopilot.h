@@ -0,0 +1,23 @@
+// Smash Out! autopilot: steers the paddle to the earliest ball landing it can reach,
+// aiming the return at the lowest live brick. Pure C99 with no raylib dependency.
+
+#ifndef SMASH_AUTOPILOT_H
+#define SMASH_AUTOPILOT_H
+
+#include <stdbool.h>
+#include "smash_sim.h"
+
+#define AUTOPILOT_HORIZON 4.0f  // Seconds ahead a landing is predicted
+
+typedef struct Autopilot {
+    float targetX;       // Where the paddle centre is heading
+    int trackedBall;     // Ball being intercepted, -1 when none lands within the horizon
+    BallLanding landing; // Its predicted landing
+    int targetBrick;     // Brick the return shot is aimed at, -1 when none is left
+    int predictions;     // Balls traced on the last tick
+} Autopilot;
+
+void ResetAutopilot(Autopilot *pilot);
+SimInput GetAutopilotInput(Autopilot *pilot, const SimState *sim);
+
+#endif // SMASH_AUTOPILOT_H
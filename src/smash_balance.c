@@ -0,0 +1,366 @@
+// Smash Out! balance simulator
+//
+// Plays many headless games with a scripted paddle on a pool of worker threads (one per
+// core by default) and prints per-level distributions of clear time, lives lost,
+// power-up uptime and score, for tuning brick mix, power-up rates and the speed ramp.
+//
+// Usage: smash_balance [--games N] [--threads N] [--levels N] [--seed N]
+//                      [--board COLSxROWS] [--balls N] [--autopilot]
+// Game g is played with seed + g, so a run is reproducible for any thread count.
+// --board plays every level on a fitted board of that size and --balls starts every
+// level with that many balls in massive-multiball mode (stress runs).
+// --autopilot drives the paddle with the trajectory-predicting autopilot instead of the
+// simple follow-the-lowest-ball script, for long soak runs that rarely lose a life.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+#include "smash_sim.h"
+#include "smash_autopilot.h"
+
+#define DEFAULT_GAMES 10000
+#define DEFAULT_MAX_LEVEL 10
+#define MAX_TRACKED_LEVELS 32
+#define LEVEL_TICK_LIMIT (SIM_TICK_RATE * 600)  // Give up on a level after 10 simulated minutes
+#define GAMES_PER_CLAIM 16  // Games a worker takes from the shared counter at once
+
+// Fixed-bin histogram, cheap to merge across workers
+#define HISTOGRAM_BINS 256
+
+typedef struct Histogram {
+    float binWidth;
+    long long bins[HISTOGRAM_BINS];  // Last bin also collects overflow
+    long long count;
+    double sum;
+} Histogram;
+
+typedef struct LevelStats {
+    Histogram clearTime;    // Seconds, cleared levels only
+    Histogram livesLost;
+    Histogram buffUptime;   // Percent of level time with a paddle buff active
+    Histogram multiUptime;  // Percent of level time with more than one ball in play
+    Histogram score;        // Points earned during the level (time bonus included)
+    long long played;
+    long long cleared;
+    long long gameOvers;
+    long long timeouts;
+} LevelStats;
+
+typedef struct BalanceStats {
+    LevelStats levels[MAX_TRACKED_LEVELS];
+    long long games;
+    long long ticks;
+} BalanceStats;
+
+typedef struct BalanceJob {
+    pthread_mutex_t lock;
+    long long nextGame;
+    long long totalGames;
+    int maxLevel;
+    uint64_t seed;  // Game g uses seed + g
+    SimConfig config;
+    bool autopilot;
+} BalanceJob;
+
+typedef struct Worker {
+    pthread_t thread;
+    BalanceJob *job;
+    BalanceStats stats;
+    SimState sim;
+    SimEventList events;
+    Autopilot pilot;
+} Worker;
+
+static void InitHistogram(Histogram *histogram, float binWidth) {
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->binWidth = binWidth;
+}
+
+static void AddSample(Histogram *histogram, float value) {
+    int bin = (int)(value / histogram->binWidth);
+    if (bin < 0) bin = 0;
+    if (bin >= HISTOGRAM_BINS) bin = HISTOGRAM_BINS - 1;
+    histogram->bins[bin]++;
+    histogram->count++;
+    histogram->sum += value;
+}
+
+static void MergeHistogram(Histogram *into, const Histogram *from) {
+    for (int i = 0; i < HISTOGRAM_BINS; i++) into->bins[i] += from->bins[i];
+    into->count += from->count;
+    into->sum += from->sum;
+}
+
+// Value below which the given fraction of samples fall (lower edge of the bin, so
+// whole-number samples such as lives lost come back exact)
+static float Percentile(const Histogram *histogram, float fraction) {
+    if (histogram->count == 0) return 0.0f;
+    long long target = (long long)(fraction * (histogram->count - 1));
+    long long seen = 0;
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        seen += histogram->bins[i];
+        if (seen > target) return i * histogram->binWidth;
+    }
+    return HISTOGRAM_BINS * histogram->binWidth;
+}
+
+static void InitBalanceStats(BalanceStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < MAX_TRACKED_LEVELS; i++) {
+        InitHistogram(&stats->levels[i].clearTime, 2.0f);
+        InitHistogram(&stats->levels[i].livesLost, 1.0f);
+        InitHistogram(&stats->levels[i].buffUptime, 1.0f);
+        InitHistogram(&stats->levels[i].multiUptime, 1.0f);
+        InitHistogram(&stats->levels[i].score, 25.0f);
+    }
+}
+
+// Scripted paddle: chase the lowest ball that is falling, otherwise drift to the centre
+static SimInput ScriptedInput(const SimState *sim) {
+    float targetX = SIM_SCREEN_WIDTH / 2.0f;
+    float lowestY = -1.0f;
+    for (int b = 0; b < sim->ballCount; b++) {
+        const Ball *ball = &sim->balls[b];
+        if (ball->speed.y <= 0.0f) continue;
+        if (ball->position.y > lowestY) {
+            lowestY = ball->position.y;
+            targetX = ball->position.x;
+        }
+    }
+
+    SimInput input = { 0 };
+    float paddleCenter = sim->paddle.x + sim->paddle.width / 2.0f;
+    float deadZone = sim->paddle.width * 0.15f;
+    if (targetX < paddleCenter - deadZone) input.buttons |= SIM_INPUT_LEFT;
+    if (targetX > paddleCenter + deadZone) input.buttons |= SIM_INPUT_RIGHT;
+    return input;
+}
+
+static void PlayGame(Worker *worker, uint64_t seed, int maxLevel) {
+    BalanceStats *stats = &worker->stats;
+    SimState *sim = &worker->sim;
+    SimEventList *events = &worker->events;
+
+    sim->config.seed = seed;
+    if (!StartGame(sim)) return;
+    ResetAutopilot(&worker->pilot);
+    stats->games++;
+
+    for (;;) {
+        int level = sim->level;
+        LevelStats *levelStats = &stats->levels[(level - 1) % MAX_TRACKED_LEVELS];
+        int scoreAtStart = sim->score;
+        int livesLost = 0;
+        long long buffTicks = 0;
+        long long multiTicks = 0;
+        long long ticks = 0;
+
+        while (sim->status == SIM_RUNNING && ticks < LEVEL_TICK_LIMIT) {
+            SimInput input = worker->job->autopilot ? GetAutopilotInput(&worker->pilot, sim) : ScriptedInput(sim);
+            StepSimulation(sim, input, events);
+            ticks++;
+
+            for (int e = 0; e < events->count; e++) {
+                if (events->events[e].type == SIM_EVENT_LIFE_LOST || events->events[e].type == SIM_EVENT_GAME_OVER) livesLost++;
+            }
+            if (sim->paddleBuffTimer > 0.0f) buffTicks++;
+            if (sim->ballCount > 1) multiTicks++;
+        }
+        stats->ticks += ticks;
+
+        levelStats->played++;
+        AddSample(&levelStats->livesLost, (float)livesLost);
+        AddSample(&levelStats->buffUptime, 100.0f * buffTicks / (float)ticks);
+        AddSample(&levelStats->multiUptime, 100.0f * multiTicks / (float)ticks);
+        AddSample(&levelStats->score, (float)(sim->score - scoreAtStart));
+
+        if (sim->status == SIM_LEVEL_CLEARED) {
+            levelStats->cleared++;
+            AddSample(&levelStats->clearTime, sim->levelCompletionTime);
+            if (level >= maxLevel) return;
+            if (!LoadLevel(sim, level + 1)) return;
+        } else {
+            if (sim->status == SIM_GAME_OVER) {
+                levelStats->gameOvers++;
+            } else {
+                levelStats->timeouts++;
+            }
+            return;
+        }
+    }
+}
+
+static void *WorkerMain(void *arg) {
+    Worker *worker = (Worker *)arg;
+    BalanceJob *job = worker->job;
+    worker->sim.config = job->config;
+
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        long long first = job->nextGame;
+        job->nextGame += GAMES_PER_CLAIM;
+        pthread_mutex_unlock(&job->lock);
+
+        if (first >= job->totalGames) break;
+        long long last = first + GAMES_PER_CLAIM;
+        if (last > job->totalGames) last = job->totalGames;
+
+        for (long long g = first; g < last; g++) PlayGame(worker, job->seed + (uint64_t)g, job->maxLevel);
+    }
+    return NULL;
+}
+
+static int GetCoreCount(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cores > 0) ? (int)cores : 1;
+#endif
+}
+
+static double GetSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void PrintDistribution(const char *name, const Histogram *histogram) {
+    if (histogram->count == 0) {
+        printf("  %-14s          -\n", name);
+        return;
+    }
+    printf("  %-14s mean %8.1f   p10 %8.1f   p50 %8.1f   p90 %8.1f\n", name,
+           histogram->sum / histogram->count,
+           Percentile(histogram, 0.10f), Percentile(histogram, 0.50f), Percentile(histogram, 0.90f));
+}
+
+int main(int argc, char *argv[]) {
+    long long games = DEFAULT_GAMES;
+    int threads = 0;
+    int maxLevel = DEFAULT_MAX_LEVEL;
+    uint64_t seed = (uint64_t)time(NULL);
+    int boardCols = 0, boardRows = 0;
+    int startBalls = 0;
+    bool autopilot = false;
+    for (int i = 1; i < argc; i += 2) {
+        const char *option = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(option, "--autopilot") == 0) {
+            autopilot = true;
+            i--;  // Takes no value
+        } else if (value != NULL && strcmp(option, "--games") == 0) {
+            games = atoll(value);
+        } else if (value != NULL && strcmp(option, "--threads") == 0) {
+            threads = atoi(value);
+        } else if (value != NULL && strcmp(option, "--levels") == 0) {
+            maxLevel = atoi(value);
+        } else if (value != NULL && strcmp(option, "--seed") == 0) {
+            seed = strtoull(value, NULL, 10);
+        } else if (value != NULL && strcmp(option, "--board") == 0 && sscanf(value, "%dx%d", &boardCols, &boardRows) == 2) {
+            // Parsed by sscanf
+        } else if (value != NULL && strcmp(option, "--balls") == 0) {
+            startBalls = atoi(value);
+        } else {
+            fprintf(stderr, "usage: smash_balance [--games N] [--threads N] [--levels N] [--seed N] [--board COLSxROWS] [--balls N] [--autopilot]\n");
+            return 1;
+        }
+    }
+    if (games < 1) games = 1;
+    if (threads < 1) threads = GetCoreCount();
+    if (maxLevel < 1) maxLevel = 1;
+    if (maxLevel > MAX_TRACKED_LEVELS) maxLevel = MAX_TRACKED_LEVELS;
+
+    BalanceJob job;
+    pthread_mutex_init(&job.lock, NULL);
+    job.nextGame = 0;
+    job.totalGames = games;
+    job.maxLevel = maxLevel;
+    job.seed = seed;
+    job.config = (SimConfig){ 0 };
+    job.autopilot = autopilot;
+    if (boardCols > 0 && boardRows > 0) job.config.customBoard = MakeFittedLayout(boardCols, boardRows);
+    if (startBalls > 0) {
+        job.config.massiveMultiball = true;
+        job.config.startBalls = startBalls;
+    }
+
+    Worker *workers = calloc(threads, sizeof(Worker));
+    if (workers == NULL) {
+        fprintf(stderr, "smash_balance: out of memory\n");
+        return 1;
+    }
+
+    printf("Simulating %lld games (up to level %d) on %d threads, seed %llu...\n", games, maxLevel, threads,
+           (unsigned long long)seed);
+    if (job.config.customBoard.cols > 0) printf("Board: %d x %d bricks\n", job.config.customBoard.cols, job.config.customBoard.rows);
+    if (job.config.massiveMultiball) printf("Massive multiball: %d balls per level\n", job.config.startBalls);
+    printf("Paddle: %s\n", autopilot ? "autopilot" : "scripted");
+    double start = GetSeconds();
+    for (int i = 0; i < threads; i++) {
+        workers[i].job = &job;
+        InitBalanceStats(&workers[i].stats);
+        if (pthread_create(&workers[i].thread, NULL, WorkerMain, &workers[i]) != 0) {
+            fprintf(stderr, "smash_balance: failed to start worker %d\n", i);
+            return 1;
+        }
+    }
+
+    BalanceStats *total = malloc(sizeof(BalanceStats));
+    if (total == NULL) {
+        fprintf(stderr, "smash_balance: out of memory\n");
+        return 1;
+    }
+    InitBalanceStats(total);
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        FreeSimState(&workers[i].sim);
+        FreeSimEventList(&workers[i].events);
+        total->games += workers[i].stats.games;
+        total->ticks += workers[i].stats.ticks;
+        for (int l = 0; l < MAX_TRACKED_LEVELS; l++) {
+            LevelStats *into = &total->levels[l];
+            const LevelStats *from = &workers[i].stats.levels[l];
+            MergeHistogram(&into->clearTime, &from->clearTime);
+            MergeHistogram(&into->livesLost, &from->livesLost);
+            MergeHistogram(&into->buffUptime, &from->buffUptime);
+            MergeHistogram(&into->multiUptime, &from->multiUptime);
+            MergeHistogram(&into->score, &from->score);
+            into->played += from->played;
+            into->cleared += from->cleared;
+            into->gameOvers += from->gameOvers;
+            into->timeouts += from->timeouts;
+        }
+    }
+    double elapsed = GetSeconds() - start;
+
+    printf("%lld games, %lld ticks in %.2fs (%.0f games/s, %.2fM ticks/s)\n\n", total->games, total->ticks, elapsed,
+           total->games / elapsed, total->ticks / elapsed / 1e6);
+
+    for (int l = 0; l < maxLevel; l++) {
+        const LevelStats *level = &total->levels[l];
+        if (level->played == 0) break;
+        printf("LEVEL %d: played %lld, cleared %.1f%%, game over %.1f%%, timed out %.1f%%\n", l + 1, level->played,
+               100.0 * level->cleared / level->played, 100.0 * level->gameOvers / level->played,
+               100.0 * level->timeouts / level->played);
+        PrintDistribution("clear time s", &level->clearTime);
+        PrintDistribution("lives lost", &level->livesLost);
+        PrintDistribution("buff uptime %", &level->buffUptime);
+        PrintDistribution("multiball %", &level->multiUptime);
+        PrintDistribution("score", &level->score);
+    }
+
+    free(total);
+    free(workers);
+    pthread_mutex_destroy(&job.lock);
+    return 0;
+}
@@ -1,26 +1,55 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <raylib.h>
+#include <rlgl.h>
 #include <time.h>
 #include <math.h>
+#include "smash_sim.h"
+#include "smash_particles.h"
+#include "smash_replay.h"
+#include "smash_snapshot.h"
+#include "smash_autopilot.h"
+#include "smash_render.h"
+#include "smash_audio.h"
 
-#define BRICKS_WIDE 10
-#define BRICKS_HIGH 5
-#define TOTAL_BRICKS (BRICKS_WIDE * BRICKS_HIGH)
-#define MAX_BALLS 5
-#define MAX_POWERUPS 50
-#define POWERUP_SPAWN_CHANCE 20  // 20% chance to spawn on brick break
-#define POWERUP_SPEED 3.0f
 #define MAX_PARTICLES 50
+#define MAX_FRAME_TIME 0.25f  // Clamp long frames so a stall doesn't queue hundreds of ticks
 
 // Global variables
-int currentLevel = 1;
 float levelNotificationTimer = 0.0f;
 float masterVolume = 0.5f;
 
-// Combo system
-int brickCombo = 0;
-float comboMultiplier = 1.0f;
+// Frame pacing, picked in settings. The simulation ticks SIM_TICK_RATE times a second
+// at any frame rate; frames between ticks draw moving things interpolated (SimMotion).
+typedef struct FrameCap {
+    const char *label;
+    int fps;     // SetTargetFPS value, 0 = no limit
+    bool vsync;  // Swap in step with the display (and no SetTargetFPS limit)
+} FrameCap;
+
+const FrameCap frameCaps[] = {
+    { "VSYNC", 0, true },
+    { "60 FPS", 60, false },
+    { "120 FPS", 120, false },
+    { "144 FPS", 144, false },
+    { "240 FPS", 240, false },
+    { "UNCAPPED", 0, false },
+};
+#define FRAME_CAP_COUNT (int)(sizeof(frameCaps) / sizeof(frameCaps[0]))
+int frameCapIndex = 1;  // 60 FPS; -1 for the custom cap from --fps
+FrameCap customFrameCap = { "CUSTOM", 0, false };
+char customFrameCapLabel[24];
+
+// Internal render resolution as a percentage of the 800x600 canvas, picked in settings
+// (or any value in range with --scale); the window shows the canvas scaled to fit
+const int renderScales[] = { 50, 75, 100, 150, 200 };
+#define RENDER_SCALE_COUNT (int)(sizeof(renderScales) / sizeof(renderScales[0]))
+#define MIN_RENDER_SCALE 50
+#define MAX_RENDER_SCALE 200
+int renderScalePercent = 100;
+
+// Combo display
 float comboDisplayTimer = 0.0f;
 
 // Floating combo text
@@ -28,94 +57,114 @@ typedef struct FloatingCombo {
     Vector2 position;
     float lifetime;
     float multiplier;
+    char text[12];  // Formatted once at spawn
+    int textWidth;
 } FloatingCombo;
 
 #define MAX_FLOATING_COMBOS 10
+#define FLOATING_COMBO_LIFETIME 1.2f
 FloatingCombo floatingCombos[MAX_FLOATING_COMBOS];
+EmitterPool floatingComboPool;  // Live combos are floatingCombos[0, count)
+
+// Cosmetic random stream (particles, shake, menu background), kept apart from the
+// simulation's gameplay stream so effects never change how a game plays out
+Rng effectsRng;
 
 // High score persistence
 int highScore = 0;
 #define HIGHSCORE_FILE "highscore.txt"
 
-// Time bonus
-float levelTimer = 0.0f;
-#define TIME_LIMIT 60.0f  // 60 seconds to get time bonus
-#define MAX_TIME_BONUS 500  // Maximum bonus points
+// Every game is recorded; the latest one is written here when it ends (smash_replayer plays it back)
+#define REPLAY_FILE "last_game.replay"
+#define REPLAY_HASH_INTERVAL SIM_TICK_RATE  // Store a state hash once per simulated second
+Replay gameReplay;
+bool replayUnsaved = false;  // A game was recorded since the last save
+
+// Rewind history (a snapshot after every tick of the current level) and the level's
+// starting state for restarts
+#define REWIND_ARENA_BYTES (8 * 1024 * 1024)
+#define REWIND_MAX_RECORDS (SIM_TICK_RATE * 20)  // Up to 20 seconds back
+#define REWIND_KEYFRAME_INTERVAL 60
+#define REWIND_SPEED 2  // Ticks undone per tick while R is held
+SnapshotRing rewindRing;
+SimSnapshot levelStart;
 
 // Screen shake
 float shakeIntensity = 0.0f;
 float shakeTimer = 0.0f;
 #define MAX_SHAKE_TIME 0.15f
 
-// Particle effects for brick destruction
-typedef struct Particle {
-    Vector2 position;
-    Vector2 velocity;
-    float lifetime;
-    Color color;
-} Particle;
+// Particle effects for brick destruction (SoA fields updated by the SIMD kernel)
+#define MAX_BRICK_PARTICLES 16384
+#define BRICK_PARTICLE_LIFETIME 0.5f
+#define PARTICLE_GRAVITY 200.0f
+ParticleField brickParticles;
 
-#define MAX_BRICK_PARTICLES 100
-Particle brickParticles[MAX_BRICK_PARTICLES];
-
-// Ball trail
-typedef struct BallTrailPoint {
-    Vector2 position;
-    float alpha;
-} BallTrailPoint;
+// Ball trails (recorded positions, one per tick)
+BallTrails ballTrails;
 
-#define MAX_TRAIL_POINTS 8
+// Positions before the latest tick, for drawing between ticks
+SimMotion simMotion;
 
 // Paddle squash/stretch
 float paddleSquashTimer = 0.0f;
 #define PADDLE_SQUASH_DURATION 0.1f
 
-// Level statistics tracking
-int bricksSmashed = 0;
-float levelCompletionTime = 0.0f;
+// Level summary screen
 float levelSummaryTimer = 0.0f;
 #define LEVEL_SUMMARY_DURATION 3.0f
 
+// Retained HUD bar (y: 0-80): rendered into hudLayer only when something it shows
+// changes, then drawn as one textured quad per frame
+#define HUD_HEIGHT 81  // The bar and the line under it
+typedef struct HudInputs {
+    int score;
+    int level;
+    int lives;        // Hearts shown (capped at 5)
+    int bricks;
+    int comboTenths;  // 0 while no combo is running
+    int timeTenths;
+    int buffPixels;   // Width of the buff bar fill, -1 while no buff is active
+} HudInputs;
+RenderTexture2D hudLayer;
+HudInputs hudShown;
+bool hudValid = false;  // hudLayer holds hudShown
+int hudLayerScale = 0;  // Render scale hudLayer was created at (percent)
+
+// Brick field cached in a render texture, redrawn brick by brick as bricks change
+BrickLayer brickLayer;
+
+// Frame stats overlay (F3): what the HUD and the rewind snapshots cost, averaged over a
+// second. F4 switches between the retained layer and drawing the HUD every frame, to compare.
+typedef struct FrameStats {
+    bool visible;
+    bool immediateHud;
+    int frames;         // Counted since windowStart
+    int hudDrawCalls;
+    int hudRedraws;
+    double hudSeconds;
+    int brickRedraws;
+    int drawCalls;      // All draw calls
+    int snapshots;
+    double snapshotSeconds;
+    double windowStart;
+    float drawCallsPerFrame;  // Last second's averages
+    float redrawsPerSecond;
+    float microsPerFrame;
+    float brickRedrawsPerSecond;
+    float frameDrawCallsPerFrame;
+    float microsPerSnapshot;
+} FrameStats;
+FrameStats frameStats;
+
+// Attract mode: after a while idle on the menu the autopilot plays a demo game
+#define ATTRACT_DELAY 15.0f   // Seconds without input on the menu before the demo starts
+#define ATTRACT_LENGTH 60.0f  // Seconds a demo runs before returning to the menu
+
 // Ball death particles
-#define MAX_DEATH_PARTICLES 50
-Particle deathParticles[MAX_DEATH_PARTICLES];
-
-typedef enum PowerUpType {
-    MULTIBALL,
-    WIDE_PADDLE,
-    SCREEN_WIDE,
-    EXTRA_LIFE
-} PowerUpType;
-
-typedef enum BrickType {
-    BRICK_NORMAL,
-    BRICK_TOUGH,
-    BRICK_EXPLOSIVE,
-    BRICK_SPEED,
-    BRICK_INVISIBLE
-} BrickType;
-
-typedef struct PowerUp {
-    Rectangle rect;
-    PowerUpType type;
-    bool active;
-    Color color;
-} PowerUp;
-
-typedef struct Brick {
-    Rectangle rect;
-    bool active;
-    BrickType type;
-    int health;  // For TOUGH bricks: 1-3 hits
-    bool discovered;  // For INVISIBLE bricks: true = revealed
-} Brick;
-
-typedef struct Ball {
-    Vector2 position;
-    Vector2 speed;
-    float radius;
-    bool active;
-} Ball;
+#define MAX_DEATH_PARTICLES 4096
+#define DEATH_PARTICLE_LIFETIME 0.6f
+ParticleField deathParticles;
 
 typedef enum GameState {
     MENU,
@@ -128,79 +177,40 @@ typedef enum GameState {
     HOW_TO_PLAY
 } GameState;
 
-void ResetGame(Brick bricks[], Ball balls[], Vector2 *ballPosition, Vector2 *ballSpeed, Rectangle *paddle) {
-    // Reset paddle
-    paddle->x = 800 / 2 - 50;
-    paddle->width = 100;
-    
-    // Reset balls
-    for (int i = 0; i < MAX_BALLS; i++) {
-        balls[i].active = false;
-    }
-    balls[0].active = true;
-    balls[0].position = (Vector2){ 800 / 2, 400 };
-    balls[0].speed = (Vector2){ 4.0f, -4.0f };
-    balls[0].radius = 8.0f;
-    
-    // Reset bricks
-    int brickWidth = 70;
-    int brickHeight = 20;
-    int padding = 10;
-    
-    for (int i = 0; i < TOTAL_BRICKS; i++) {
-        int row = i / BRICKS_WIDE;
-        int col = i % BRICKS_WIDE;
-        
-        bricks[i].rect = (Rectangle){ 
-            col * (brickWidth + padding) + 40, 
-            row * (brickHeight + padding) + 50, 
-            brickWidth, 
-            brickHeight 
-        };
-        bricks[i].active = true;
-    }
-}
-
-int CountActiveBricks(Brick bricks[]) {
-    int count = 0;
-    for (int i = 0; i < TOTAL_BRICKS; i++) {
-        if (bricks[i].active) count++;
-    }
-    return count;
-}
-
-Color GetBrickColor(Brick brick) {
-    // Determine color based on brick type
-    switch (brick.type) {
-        case BRICK_NORMAL: {
-            // Standard row-based coloring
-            int row = 0;
-            for (int i = 0; i < TOTAL_BRICKS; i++) {
-                if (i / BRICKS_WIDE == row) break;
-            }
-            switch (row % 5) {
-                case 0: return RED;
-                case 1: return ORANGE;
-                case 2: return YELLOW;
-                case 3: return GREEN;
-                case 4: return BLUE;
-                default: return RED;
-            }
-        }
-        case BRICK_TOUGH:
-            // Change color based on health (3=dark red, 2=red, 1=pink)
-            if (brick.health == 3) return (Color){80, 0, 0, 255};  // Dark Red
-            if (brick.health == 2) return RED;
-            return (Color){255, 100, 150, 255};  // Pink
-        case BRICK_EXPLOSIVE:
-            return PURPLE;  // Purple for explosive
-        case BRICK_SPEED:
-            return LIME;  // Lime for speed boosts
-        case BRICK_INVISIBLE:
-            return brick.discovered ? GRAY : (Color){0, 0, 0, 0};  // Invisible until hit
-        default:
-            return WHITE;
-    }
+// Headless render test (--render-test DIR): plays a fixed script through every screen
+// in a hidden window at a fixed frame time, rendering each frame into an offscreen
+// framebuffer. The last frame of each step is read back and compared with the golden
+// image DIR/<step>.png (written when missing); a mismatch is saved next to it as
+// DIR/<step>.actual.png. Draw calls and CPU render time per frame are reported for
+// every step, and the 10 s autopilot "playing" step doubles as a render benchmark.
+// Machines without a display can run it on a software GL under a virtual X server:
+// LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./smash_out --render-test golden
+#define RENDER_TEST_SEED 20240501ULL
+#define RENDER_TEST_FRAME_TIME (1.0f / 60.0f)
+#define RENDER_TEST_TOLERANCE 8           // Largest channel difference still counted as equal
+#define RENDER_TEST_MAX_MISMATCH 0.001f   // Fraction of pixels allowed to differ
+
+typedef struct RenderTestStep {
+    const char *name;
+    GameState state;
+    int frames;  // Frames rendered in this state; the last one is captured
+} RenderTestStep;
+
+static const RenderTestStep renderTestSteps[] = {
+    { "menu", MENU, 30 },
+    { "how_to_play", HOW_TO_PLAY, 2 },
+    { "settings", SETTINGS, 2 },
+    { "playing", PLAYING, 600 },
+    { "paused", PAUSED, 2 },
+    { "level_summary", LEVEL_SUMMARY, 2 },
+    { "game_over", GAME_OVER, 2 },
+    { "win", WIN, 2 }
+};
+#define RENDER_TEST_STEPS (int)(sizeof(renderTestSteps) / sizeof(renderTestSteps[0]))
+
+// raylib views of simulation geometry
+Vector2 ToVector2(SimVec2 vec) {
+    return (Vector2){ vec.x, vec.y };
 }
 
 Color GetPowerUpColor(PowerUpType type) {
@@ -213,48 +223,20 @@ Color GetPowerUpColor(PowerUpType type) {
     }
 }
 
-void SpawnPowerUp(PowerUp powerups[], int x, int y) {
-    // Find first inactive power-up slot
-    for (int i = 0; i < MAX_POWERUPS; i++) {
-        if (!powerups[i].active) {
-            int randomType = rand() % 4;
-            powerups[i].type = (PowerUpType)randomType;
-            powerups[i].rect = (Rectangle){ x, y, 20, 20 };
-            powerups[i].active = true;
-            powerups[i].color = GetPowerUpColor(powerups[i].type);
-            break;
-        }
-    }
-}
-
-void SpawnBall(Ball balls[], Vector2 position, Vector2 baseSpeed) {
-    for (int i = 0; i < MAX_BALLS; i++) {
-        if (!balls[i].active) {
-            balls[i].active = true;
-            balls[i].position = position;
-            // Random horizontal velocity variation
-            float speedVariation = (rand() % 100 - 50) / 100.0f * 4.0f;
-            balls[i].speed = (Vector2){ baseSpeed.x + speedVariation, baseSpeed.y };
-            balls[i].radius = 8.0f;
-            break;
-        }
-    }
-}
-
 // Button drawing helper - returns true when clicked
 bool DrawButton(Rectangle bounds, const char* text, int fontSize, Color normalColor, Color hoverColor) {
     Vector2 mousePos = GetMousePosition();
     bool isHovered = CheckCollisionPointRec(mousePos, bounds);
     
     Color buttonColor = isHovered ? hoverColor : normalColor;
-    DrawRectangleRec(bounds, buttonColor);
-    DrawRectangleLines((int)bounds.x, (int)bounds.y, (int)bounds.width, (int)bounds.height, WHITE);
+    DrawRectangleRecCounted(bounds, buttonColor);
+    DrawRectangleLinesCounted((int)bounds.x, (int)bounds.y, (int)bounds.width, (int)bounds.height, WHITE);
     
     // Draw text centered
-    int textWidth = MeasureText(text, fontSize);
+    int textWidth = MeasureTextCached(text, fontSize);
     int textX = (int)(bounds.x + bounds.width / 2 - textWidth / 2);
     int textY = (int)(bounds.y + bounds.height / 2 - fontSize / 2);
-    DrawText(text, textX, textY, fontSize, isHovered ? BLACK : WHITE);
+    DrawTextCounted(text, textX, textY, fontSize, isHovered ? BLACK : WHITE);
     
     // Return true if clicked
     return isHovered && IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
@@ -263,18 +245,18 @@ bool DrawButton(Rectangle bounds, const char* text, int fontSize, Color normalCo
 // Initialize menu particles
 void InitializeParticles(Vector2 particles[], int count) {
     for (int i = 0; i < count; i++) {
-        particles[i].x = (float)(rand() % 800);
-        particles[i].y = (float)(rand() % 600);
+        particles[i].x = (float)RandomInt(&effectsRng, 800);
+        particles[i].y = (float)RandomInt(&effectsRng, 600);
     }
 }
 
-// Update particles
-void UpdateParticles(Vector2 particles[], int count, float speed) {
+// Update particles (speed in pixels per second)
+void UpdateParticles(Vector2 particles[], int count, float speed, float deltaTime) {
     for (int i = 0; i < count; i++) {
-        particles[i].y += speed;
+        particles[i].y += speed * deltaTime;
         if (particles[i].y > 600) {
             particles[i].y = -10.0f;
-            particles[i].x = (float)(rand() % 800);
+            particles[i].x = (float)RandomInt(&effectsRng, 800);
         }
     }
 }
@@ -282,123 +264,259 @@ void UpdateParticles(Vector2 particles[], int count, float speed) {
 // Draw particles
 void DrawParticles(Vector2 particles[], int count, Color color) {
     for (int i = 0; i < count; i++) {
-        DrawCircle((int)particles[i].x, (int)particles[i].y, 2, color);
+        DrawCircleCounted((int)particles[i].x, (int)particles[i].y, 2, color);
     }
 }
 
 // Helper function to draw text with shadow
 void DrawTextWithShadow(const char* text, int posX, int posY, int fontSize, Color color) {
-    DrawText(text, posX + 2, posY + 2, fontSize, BLACK);
-    DrawText(text, posX, posY, fontSize, color);
+    DrawTextCounted(text, posX + 2, posY + 2, fontSize, BLACK);
+    DrawTextCounted(text, posX, posY, fontSize, color);
 }
 
-// Spawn floating combo text at brick location
-void SpawnFloatingCombo(Vector2 brickPos, float multiplier) {
-    for (int i = 0; i < MAX_FLOATING_COMBOS; i++) {
-        if (floatingCombos[i].lifetime <= 0.0f) {
-            floatingCombos[i].position = brickPos;
-            floatingCombos[i].lifetime = 1.2f;  // 1.2 second lifetime
-            floatingCombos[i].multiplier = multiplier;
-            break;
+HudInputs GetHudInputs(const SimState *sim) {
+    HudInputs inputs = { 0 };
+    inputs.score = sim->score;
+    inputs.level = sim->level;
+    inputs.lives = sim->lives > 5 ? 5 : sim->lives;  // Cap at 5 hearts
+    inputs.bricks = sim->bricks.activeCount;
+    inputs.comboTenths = (sim->brickCombo > 1) ? (int)(sim->comboMultiplier * 10.0f + 0.5f) : 0;
+    inputs.timeTenths = (int)(sim->levelTimer * 10.0f);
+    inputs.buffPixels = -1;
+    if (sim->paddleBuffTimer > 0.0f) {
+        float buffProgress = sim->paddleBuffTimer / 10.0f;
+        if (buffProgress > 1.0f) buffProgress = 1.0f;
+        inputs.buffPixels = (int)(50 * buffProgress);
+    }
+    return inputs;
+}
+
+// === CLEAN MINIMALIST HUD (y: 0-80) ===
+void DrawHudBar(const HudInputs *hud, int screenWidth) {
+    // Main HUD Bar Background
+    DrawRectangleCounted(0, 0, screenWidth, 80, Fade((Color){20, 20, 30, 255}, 0.85f));
+    DrawLineCounted(0, 80, screenWidth, 80, (Color){100, 100, 120, 255});
+
+    // LEFT SECTION: Score and Level
+    DrawTextWithShadow("SCORE", 20, 12, 14, ORANGE);
+    char scoreStr[20];
+    sprintf_s(scoreStr, sizeof(scoreStr), "%d", hud->score);
+    DrawTextWithShadow(scoreStr, 20, 32, 28, YELLOW);
+
+    DrawTextWithShadow("LEVEL", 130, 12, 14, ORANGE);
+    char levelStr[10];
+    sprintf_s(levelStr, sizeof(levelStr), "%d", hud->level);
+    DrawTextWithShadow(levelStr, 130, 32, 28, GREEN);
+
+    // CENTER SECTION: Bricks and Combo
+    char bricksStr[20];
+    sprintf_s(bricksStr, sizeof(bricksStr), "BRICKS: %d", hud->bricks);
+    int bricksWidth = MeasureText(bricksStr, 18);
+    DrawTextWithShadow(bricksStr, screenWidth / 2 - bricksWidth / 2, 15, 18, SKYBLUE);
+
+    // Combo display in center
+    if (hud->comboTenths > 0) {
+        char comboStr[20];
+        sprintf_s(comboStr, sizeof(comboStr), "COMBO: %d.%dx", hud->comboTenths / 10, hud->comboTenths % 10);
+        int comboWidth = MeasureText(comboStr, 18);
+        Color comboColor = (Color){255, 200, 0, 255};  // Golden
+        DrawTextWithShadow(comboStr, screenWidth / 2 - comboWidth / 2, 42, 18, comboColor);
+    }
+
+    // RIGHT SECTION: Time and Lives
+    // Hearts (Lives) - positioned before time
+    int heartsStartX = screenWidth - 220;
+    int heartsStartY = 48;
+
+    char timeStr[20];
+    sprintf_s(timeStr, sizeof(timeStr), "%d.%ds", hud->timeTenths / 10, hud->timeTenths % 10);
+    DrawTextWithShadow("TIME", screenWidth - 100, 12, 14, ORANGE);
+    DrawTextWithShadow(timeStr, screenWidth - 100, 32, 24, SKYBLUE);
+
+    for (int i = 0; i < hud->lives; i++) {
+        Vector2 heartPos = { (float)(heartsStartX + (i * 28)), (float)heartsStartY };
+        DrawHudIcon(HUD_ICON_HEART, heartPos, 3.0f, RED);
+    }
+
+    // Buff progress bar (if active)
+    if (hud->buffPixels >= 0) {
+        DrawTextCounted("BUFF", heartsStartX - 60, 52, 12, LIME);
+
+        Rectangle buffBarBg = {heartsStartX - 60, 68, 50, 6};
+        DrawRectangleRecCounted(buffBarBg, DARKGRAY);
+        DrawRectangleLinesCounted((int)buffBarBg.x, (int)buffBarBg.y, (int)buffBarBg.width, (int)buffBarBg.height, LIME);
+
+        Rectangle buffBarFill = {buffBarBg.x, buffBarBg.y, (float)hud->buffPixels, buffBarBg.height};
+        DrawRectangleRecCounted(buffBarFill, LIME);
+    }
+}
+
+// (Re)create hudLayer at the canvas' render scale, so it maps 1:1 onto canvas pixels.
+// Call outside BeginDrawing/EndDrawing; a failed texture is only retried at another scale.
+bool PrepareHudLayer(int screenWidth, int scalePercent) {
+    if (scalePercent == hudLayerScale) return IsRenderTextureReady(hudLayer);
+    if (IsRenderTextureReady(hudLayer)) UnloadRenderTexture(hudLayer);
+    hudLayer = LoadRenderTexture(screenWidth * scalePercent / 100, HUD_HEIGHT * scalePercent / 100);
+    hudLayerScale = scalePercent;
+    hudValid = false;
+    return IsRenderTextureReady(hudLayer);
+}
+
+// Re-render hudLayer if what the HUD shows has changed (score, lives, level, bricks,
+// combo, the tenth-of-a-second timer, buff bar). Call outside BeginDrawing/EndDrawing.
+// Returns the draw calls the re-render issued, 0 when the layer was still current.
+int UpdateHudLayer(const SimState *sim, int screenWidth) {
+    HudInputs inputs = GetHudInputs(sim);
+    if (hudValid && memcmp(&inputs, &hudShown, sizeof(inputs)) == 0) return 0;
+
+    // The layer keeps premultiplied alpha: color blends as usual, alpha accumulates, so
+    // the translucent bar composites the same as when it was drawn straight to the screen
+    BeginTextureMode(hudLayer);
+    ClearBackground(BLANK);
+    BeginMode2D((Camera2D){ .zoom = hudLayerScale / 100.0f });
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    int drawCalls = renderDrawCalls;
+    DrawHudBar(&inputs, screenWidth);
+    drawCalls = renderDrawCalls - drawCalls;
+    EndBlendMode();
+    EndMode2D();
+    EndTextureMode();
+
+    hudShown = inputs;
+    hudValid = true;
+    return drawCalls;
+}
+
+void DrawHudLayer(void) {
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    // Render textures are stored bottom-up, so flip the source rectangle
+    Rectangle source = { 0.0f, 0.0f, (float)hudLayer.texture.width, -(float)hudLayer.texture.height };
+    Rectangle dest = { 0.0f, 0.0f, hudLayer.texture.width * 100.0f / hudLayerScale, hudLayer.texture.height * 100.0f / hudLayerScale };
+    DrawTextureProCounted(hudLayer.texture, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    EndBlendMode();
+}
+
+void DrawFrameStats(int screenHeight) {
+    char statsStr[160];
+    sprintf_s(statsStr, sizeof(statsStr), "%d FPS  %.0f draw calls  HUD (%s): %.1f draw calls, %.0f redraws/s, %.1f us  Bricks: %.0f redrawn/s",
+              GetFPS(), frameStats.frameDrawCallsPerFrame, frameStats.immediateHud ? "immediate" : "retained",
+              frameStats.drawCallsPerFrame, frameStats.redrawsPerSecond, frameStats.microsPerFrame,
+              frameStats.brickRedrawsPerSecond);
+    DrawTextCounted(statsStr, 10, screenHeight - 20, 10, LIME);
+    sprintf_s(statsStr, sizeof(statsStr), "Rewind snapshots: %.1f us per capture", frameStats.microsPerSnapshot);
+    DrawTextCounted(statsStr, 10, screenHeight - 32, 10, LIME);
+}
+
+// Compare a rendered frame with DIR/name.png. Returns the number of pixels that differ,
+// 0 when the golden image was missing and has been written, -1 on an I/O error.
+int CompareRenderTestFrame(Image frame, const char *dir, const char *name) {
+    char goldenPath[512];
+    char actualPath[512];
+    sprintf_s(goldenPath, sizeof(goldenPath), "%s/%s.png", dir, name);
+    sprintf_s(actualPath, sizeof(actualPath), "%s/%s.actual.png", dir, name);
+
+    Image golden = LoadImage(goldenPath);
+    if (!IsImageReady(golden)) {
+        return ExportImage(frame, goldenPath) ? 0 : -1;
+    }
+
+    int mismatched = frame.width * frame.height;
+    if (golden.width == frame.width && golden.height == frame.height) {
+        Color *expected = LoadImageColors(golden);
+        Color *actual = LoadImageColors(frame);
+        mismatched = 0;
+        for (int i = 0; i < frame.width * frame.height; i++) {
+            if (abs(expected[i].r - actual[i].r) > RENDER_TEST_TOLERANCE ||
+                abs(expected[i].g - actual[i].g) > RENDER_TEST_TOLERANCE ||
+                abs(expected[i].b - actual[i].b) > RENDER_TEST_TOLERANCE ||
+                abs(expected[i].a - actual[i].a) > RENDER_TEST_TOLERANCE) mismatched++;
         }
+        UnloadImageColors(expected);
+        UnloadImageColors(actual);
     }
+    UnloadImage(golden);
+    if (mismatched > 0) ExportImage(frame, actualPath);
+    return mismatched;
+}
+
+// Spawn floating combo text at brick location (replaces the oldest when all are showing)
+void SpawnFloatingCombo(Vector2 brickPos, float multiplier) {
+    int i = AcquirePoolSlot(&floatingComboPool);
+    if (i < 0) return;
+    floatingCombos[i].position = brickPos;
+    floatingCombos[i].lifetime = FLOATING_COMBO_LIFETIME;
+    floatingCombos[i].multiplier = multiplier;
+    sprintf_s(floatingCombos[i].text, sizeof(floatingCombos[i].text), "%.1fx!", multiplier);
+    floatingCombos[i].textWidth = MeasureTextCached(floatingCombos[i].text, 28);
 }
 
-// Update floating combo text
+// Update floating combo text, keeping live combos packed at the front, oldest first
 void UpdateFloatingCombos(float deltaTime) {
-    for (int i = 0; i < MAX_FLOATING_COMBOS; i++) {
+    int live = 0;
+    int newest = 0;  // Survivors of slots recycled since the last update
+    for (int i = 0; i < floatingComboPool.count; i++) {
+        floatingCombos[i].lifetime -= deltaTime;
+        floatingCombos[i].position.y -= 40.0f * deltaTime;  // Rise upward
         if (floatingCombos[i].lifetime > 0.0f) {
-            floatingCombos[i].lifetime -= deltaTime;
-            floatingCombos[i].position.y -= 40.0f * deltaTime;  // Rise upward
+            if (i < floatingComboPool.evictCursor) newest++;
+            floatingCombos[live++] = floatingCombos[i];
         }
     }
+    if (newest > 0 && newest < live) {
+        FloatingCombo recycled[MAX_FLOATING_COMBOS];
+        memcpy(recycled, floatingCombos, newest * sizeof(FloatingCombo));
+        memmove(floatingCombos, floatingCombos + newest, (live - newest) * sizeof(FloatingCombo));
+        memcpy(floatingCombos + live - newest, recycled, newest * sizeof(FloatingCombo));
+    }
+    SetPoolCount(&floatingComboPool, live);
 }
 
 // Draw floating combo text
 void DrawFloatingCombos() {
-    for (int i = 0; i < MAX_FLOATING_COMBOS; i++) {
-        if (floatingCombos[i].lifetime > 0.0f) {
-            float alpha = floatingCombos[i].lifetime / 1.2f;  // Fade effect
-            
-            char comboText[20];
-            sprintf_s(comboText, sizeof(comboText), "%.1fx!", floatingCombos[i].multiplier);
-            int textWidth = MeasureText(comboText, 28);
-            
-            Color comboColor = (Color){255, 165, 0, (unsigned char)(255 * alpha)};
-            DrawText(comboText, (int)floatingCombos[i].position.x + 1 - textWidth / 2, 
-                    (int)floatingCombos[i].position.y + 1, 28, (Color){0, 0, 0, (unsigned char)(150 * alpha)});
-            DrawText(comboText, (int)floatingCombos[i].position.x - textWidth / 2, 
-                    (int)floatingCombos[i].position.y, 28, comboColor);
-        }
+    for (int i = 0; i < floatingComboPool.count; i++) {
+        float alpha = floatingCombos[i].lifetime / FLOATING_COMBO_LIFETIME;  // Fade effect
+        
+        const char *comboText = floatingCombos[i].text;
+        int textWidth = floatingCombos[i].textWidth;
+        
+        Color comboColor = (Color){255, 165, 0, (unsigned char)(255 * alpha)};
+        DrawTextCounted(comboText, (int)floatingCombos[i].position.x + 1 - textWidth / 2, 
+                (int)floatingCombos[i].position.y + 1, 28, (Color){0, 0, 0, (unsigned char)(150 * alpha)});
+        DrawTextCounted(comboText, (int)floatingCombos[i].position.x - textWidth / 2, 
+                (int)floatingCombos[i].position.y, 28, comboColor);
     }
 }
 
 // Initialize floating combos
 void InitializeFloatingCombos() {
-    for (int i = 0; i < MAX_FLOATING_COMBOS; i++) {
-        floatingCombos[i].lifetime = 0.0f;
-    }
+    InitEmitterPool(&floatingComboPool, MAX_FLOATING_COMBOS, POOL_DROP_OLDEST);
 }
 
-// Initialize brick particles
-void InitializeBrickParticles() {
-    for (int i = 0; i < MAX_BRICK_PARTICLES; i++) {
-        brickParticles[i].lifetime = 0.0f;
-    }
-}
-
-// Initialize death particles
-void InitializeDeathParticles() {
-    for (int i = 0; i < MAX_DEATH_PARTICLES; i++) {
-        deathParticles[i].lifetime = 0.0f;
-    }
+// Allocate the particle fields (done once at startup)
+bool InitializeParticleFields() {
+    return InitParticleField(&brickParticles, MAX_BRICK_PARTICLES, POOL_DROP_OLDEST,
+                             BRICK_PARTICLE_LIFETIME, PARTICLE_GRAVITY, 200.0f) &&
+           InitParticleField(&deathParticles, MAX_DEATH_PARTICLES, POOL_DROP_OLDEST,
+                             DEATH_PARTICLE_LIFETIME, PARTICLE_GRAVITY, 200.0f);
 }
 
 // Spawn brick particles on destruction
 void SpawnBrickParticles(Vector2 position, int count) {
     for (int i = 0; i < count; i++) {
-        for (int j = 0; j < MAX_BRICK_PARTICLES; j++) {
-            if (brickParticles[j].lifetime <= 0.0f) {
-                brickParticles[j].position = position;
-                // Random velocity in all directions
-                float angle = (rand() % 360) * 3.14159f / 180.0f;
-                float speed = 50.0f + (rand() % 100);
-                brickParticles[j].velocity.x = cosf(angle) * speed;
-                brickParticles[j].velocity.y = sinf(angle) * speed;
-                brickParticles[j].lifetime = 0.5f;  // 0.5 second lifetime
-                brickParticles[j].color = RED;
-                break;
-            }
-        }
+        // Random velocity in all directions
+        float angle = RandomInt(&effectsRng, 360) * 3.14159f / 180.0f;
+        float speed = 50.0f + RandomInt(&effectsRng, 100);
+        SpawnParticle(&brickParticles, position.x, position.y, cosf(angle) * speed, sinf(angle) * speed);
     }
 }
 
-// Update brick particles
-void UpdateBrickParticles(float deltaTime) {
-    for (int i = 0; i < MAX_BRICK_PARTICLES; i++) {
-        if (brickParticles[i].lifetime > 0.0f) {
-            brickParticles[i].lifetime -= deltaTime;
-            brickParticles[i].position.x += brickParticles[i].velocity.x * deltaTime;
-            brickParticles[i].position.y += brickParticles[i].velocity.y * deltaTime;
-            // Apply gravity
-            brickParticles[i].velocity.y += 200.0f * deltaTime;
-        }
-    }
-}
-
-// Draw brick particles with fade
-void DrawBrickParticles() {
-    for (int i = 0; i < MAX_BRICK_PARTICLES; i++) {
-        if (brickParticles[i].lifetime > 0.0f) {
-            float alpha = brickParticles[i].lifetime / 0.5f;  // Fade from full to transparent
-            Color particleColor = (Color){
-                brickParticles[i].color.r,
-                brickParticles[i].color.g,
-                brickParticles[i].color.b,
-                (unsigned char)(200 * alpha)
-            };
-            DrawCircleV(brickParticles[i].position, 3.0f, particleColor);
-        }
+// Draw a particle field with the fade alpha computed by its update. Particles are
+// drawn lag seconds back along their velocity, level with the interpolated balls.
+void DrawParticleField(const ParticleField *field, float radius, Color color, float lag) {
+    for (int i = 0; i < field->pool.count; i++) {
+        color.a = (unsigned char)field->alpha[i];
+        DrawCircleVCounted((Vector2){ field->posX[i] - field->velX[i] * lag, field->posY[i] - field->velY[i] * lag }, radius, color);
     }
 }
 
@@ -411,48 +529,43 @@ void TriggerScreenShake(float intensity) {
 // Spawn death particles when ball falls off screen
 void SpawnDeathParticles(Vector2 ballPos) {
     for (int i = 0; i < 12; i++) {
-        for (int j = 0; j < MAX_DEATH_PARTICLES; j++) {
-            if (deathParticles[j].lifetime <= 0.0f) {
-                deathParticles[j].position = ballPos;
-                float angle = (i / 12.0f) * 2.0f * 3.14159f;  // Spread in circle
-                float speed = 100.0f + (rand() % 50);
-                deathParticles[j].velocity.x = cosf(angle) * speed;
-                deathParticles[j].velocity.y = sinf(angle) * speed;
-                deathParticles[j].lifetime = 0.6f;
-                deathParticles[j].color = LIGHTGRAY;
-                break;
-            }
-        }
+        float angle = (i / 12.0f) * 2.0f * 3.14159f;  // Spread in circle
+        float speed = 100.0f + RandomInt(&effectsRng, 50);
+        SpawnParticle(&deathParticles, ballPos.x, ballPos.y, cosf(angle) * speed, sinf(angle) * speed);
     }
 }
 
-// Update death particles
-void UpdateDeathParticles(float deltaTime) {
-    for (int i = 0; i < MAX_DEATH_PARTICLES; i++) {
-        if (deathParticles[i].lifetime > 0.0f) {
-            deathParticles[i].lifetime -= deltaTime;
-            deathParticles[i].position.x += deathParticles[i].velocity.x * deltaTime;
-            deathParticles[i].position.y += deathParticles[i].velocity.y * deltaTime;
-            // Apply gravity
-            deathParticles[i].velocity.y += 200.0f * deltaTime;
-        }
+// Frame cap currently selected
+FrameCap GetFrameCap() {
+    return (frameCapIndex < 0) ? customFrameCap : frameCaps[frameCapIndex];
+}
+
+// Switch the window's frame pacing
+void ApplyFrameCap(FrameCap cap) {
+    if (cap.vsync) {
+        SetWindowState(FLAG_VSYNC_HINT);
+    } else {
+        ClearWindowState(FLAG_VSYNC_HINT);
     }
+    SetTargetFPS(cap.fps);
 }
 
-// Draw death particles
-void DrawDeathParticles() {
-    for (int i = 0; i < MAX_DEATH_PARTICLES; i++) {
-        if (deathParticles[i].lifetime > 0.0f) {
-            float alpha = deathParticles[i].lifetime / 0.6f;
-            Color particleColor = (Color){
-                deathParticles[i].color.r,
-                deathParticles[i].color.g,
-                deathParticles[i].color.b,
-                (unsigned char)(200 * alpha)
-            };
-            DrawCircleV(deathParticles[i].position, 4.0f, particleColor);
-        }
+// Step through the presets (leaving a custom cap behind)
+void CycleFrameCap(int direction) {
+    if (frameCapIndex < 0) frameCapIndex = (direction > 0) ? -1 : 0;
+    frameCapIndex = (frameCapIndex + direction + FRAME_CAP_COUNT) % FRAME_CAP_COUNT;
+    ApplyFrameCap(GetFrameCap());
+}
+
+// Next preset render scale up or down from the current one
+void CycleRenderScale(int direction) {
+    int i = (direction > 0) ? 0 : RENDER_SCALE_COUNT - 1;
+    while (i >= 0 && i < RENDER_SCALE_COUNT &&
+           ((direction > 0) ? renderScales[i] <= renderScalePercent : renderScales[i] >= renderScalePercent)) {
+        i += direction;
     }
+    if (i < 0 || i >= RENDER_SCALE_COUNT) i = (direction > 0) ? 0 : RENDER_SCALE_COUNT - 1;  // Wrap around
+    renderScalePercent = renderScales[i];
 }
 
 // Load high score from file
@@ -483,240 +596,299 @@ void UpdateHighScore(int currentScore) {
     }
 }
 
-// Load level with procedural layout
-void LoadLevel(int level, Brick bricks[], Ball balls[]) {
-    // Reset brick counter
-    bricksSmashed = 0;
-    
-    // Calculate number of rows based on level (capped at 8)
-    int rows = 2 + level;
-    if (rows > 8) rows = 8;
-
-    int brickWidth = 70;
-    int brickHeight = 20;
-    int padding = 10;
-    int topMargin = 120;  // Move bricks down to create HUD space (HUD is y:0-75)
-    
-    // Deactivate all bricks first
-    for (int i = 0; i < TOTAL_BRICKS; i++) {
-        bricks[i].active = false;
-        bricks[i].type = BRICK_NORMAL;
-        bricks[i].health = 1;
-        bricks[i].discovered = true;
+// Write the current game's recording to REPLAY_FILE, once per game
+void SaveGameReplay() {
+    if (!replayUnsaved) return;
+    replayUnsaved = false;
+    if (SaveReplay(&gameReplay, REPLAY_FILE)) {
+        TraceLog(LOG_INFO, "GAME: Replay saved to %s (%u ticks, %u bytes of input)", REPLAY_FILE,
+                 gameReplay.tickCount, (unsigned int)gameReplay.runBytes);
+    } else {
+        TraceLog(LOG_WARNING, "GAME: Failed to save replay to %s", REPLAY_FILE);
     }
-    
-    // Create pattern based on level
-    for (int i = 0; i < TOTAL_BRICKS; i++) {
-        int row = i / BRICKS_WIDE;
-        int col = i % BRICKS_WIDE;
-        
-        // Only fill up to the calculated number of rows
-        if (row >= rows) {
-            bricks[i].active = false;
-            continue;
-        }
-        
-        bricks[i].rect = (Rectangle){ 
-            col * (brickWidth + padding) + 40, 
-            row * (brickHeight + padding) + topMargin,  // Apply top margin
-            brickWidth, 
-            brickHeight 
-        };
-        
-        // Apply pattern based on level
-        if (level % 2 == 0) {
-            // Checkerboard pattern for even levels
-            bricks[i].active = ((row + col) % 2 == 0);
-        } else if (level % 3 == 0) {
-            // V-Shape/Pyramid pattern for levels divisible by 3
-            int distFromCenter = col - (BRICKS_WIDE / 2);
-            bricks[i].active = (row >= abs(distFromCenter) - 1);
-        } else {
-            // Default: fill all bricks
-            bricks[i].active = true;
-        }
-        
-        // Assign brick types randomly (only for active bricks)
-        if (bricks[i].active) {
-            int typeRoll = rand() % 100;
-            if (typeRoll < 60) {
-                // 60% Normal
-                bricks[i].type = BRICK_NORMAL;
-                bricks[i].health = 1;
-            } else if (typeRoll < 75) {
-                // 15% Tough (increases with level)
-                bricks[i].type = BRICK_TOUGH;
-                bricks[i].health = (level >= 3) ? 3 : (level == 2 ? 2 : 1);
-            } else if (typeRoll < 85) {
-                // 10% Explosive
-                bricks[i].type = BRICK_EXPLOSIVE;
-                bricks[i].health = 1;
-            } else if (typeRoll < 92) {
-                // 7% Speed
-                bricks[i].type = BRICK_SPEED;
-                bricks[i].health = 1;
-            } else {
-                // 8% Invisible (increases with level)
-                bricks[i].type = BRICK_INVISIBLE;
-                bricks[i].health = 1;
-                bricks[i].discovered = (level == 1) ? true : false;
-            }
-        }
+}
+
+// Start the rewind history and restart point at the current state (a level just loaded)
+void BeginLevelHistory(const SimState *sim) {
+    SaveSimSnapshot(&levelStart, sim);
+    ClearSnapshotRing(&rewindRing);
+    CaptureSnapshot(&rewindRing, sim);
+}
+
+// Advance cosmetic timers and particles by one simulation tick
+void UpdateEffects(float deltaTime) {
+    // Update combo display timer
+    if (comboDisplayTimer > 0.0f) {
+        comboDisplayTimer -= deltaTime;
     }
-    
-    // Reset balls with increased speed per level
-    for (int i = 0; i < MAX_BALLS; i++) {
-        balls[i].active = false;
+
+    // Update level notification timer
+    if (levelNotificationTimer > 0.0f) {
+        levelNotificationTimer -= deltaTime;
     }
-    balls[0].active = true;
-    balls[0].position = (Vector2){ 400, 500 };
-    balls[0].speed.x = 4.0f;
-    balls[0].speed.y = -(4.0f + (level - 1) * 0.5f);  // Increase speed per level
-    balls[0].radius = 8.0f;
-    
-    // Show level notification
-    levelNotificationTimer = 3.0f;  // Changed to 3 seconds
-}
 
-// Get the number of active bricks in current level
-int CountActiveBricksInLevel(Brick bricks[]) {
-    int count = 0;
-    for (int i = 0; i < TOTAL_BRICKS; i++) {
-        if (bricks[i].active) count++;
+    // Update screen shake
+    if (shakeTimer > 0.0f) {
+        shakeTimer -= deltaTime;
     }
-    return count;
-}
 
-// Destroy adjacent bricks for explosive brick effect
-void DestroyAdjacentBricks(Brick bricks[], int brickIndex, int *scoreBonus) {
-    if (brickIndex < 0 || brickIndex >= TOTAL_BRICKS) return;
-    
-    int row = brickIndex / BRICKS_WIDE;
-    
-    // Define adjacent positions (up, down, left, right)
-    int adjacentOffsets[] = { -BRICKS_WIDE, BRICKS_WIDE, -1, 1 };
-    
-    for (int i = 0; i < 4; i++) {
-        int adjacentIndex = brickIndex + adjacentOffsets[i];
-        
-        // Check bounds
-        if (adjacentIndex < 0 || adjacentIndex >= TOTAL_BRICKS) continue;
-        
-        // Don't destroy bricks on wrong row (for left/right neighbors)
-        int adjRow = adjacentIndex / BRICKS_WIDE;
-        if ((i == 2 || i == 3) && adjRow != row) continue;  // Left/right check
-        
-        // Destroy adjacent brick
-        if (bricks[adjacentIndex].active) {
-            bricks[adjacentIndex].active = false;
-            *scoreBonus += 10;
-        }
+    // Update paddle squash timer
+    if (paddleSquashTimer > 0.0f) {
+        paddleSquashTimer -= deltaTime;
     }
+
+    UpdateParticleField(&brickParticles, deltaTime);
+    UpdateParticleField(&deathParticles, deltaTime);
+    UpdateFloatingCombos(deltaTime);
+}
+
+// Clear every cosmetic effect (new game, new level, restart or rewind)
+void ResetEffects() {
+    ClearBallTrails(&ballTrails);
+    comboDisplayTimer = 0.0f;
+    shakeTimer = 0.0f;
+    paddleSquashTimer = 0.0f;
+    ClearParticleField(&brickParticles);
+    ClearParticleField(&deathParticles);
+    InitializeFloatingCombos();
+}
+
+// Put the level back to how it started. The recording is cut back to match, so the
+// replay still plays exactly what ended up on screen.
+bool RestartLevel(SimState *sim) {
+    if (!LoadSimSnapshot(&levelStart, sim)) return false;
+    TruncateReplay(&gameReplay, (uint32_t)sim->tick);
+    replayUnsaved = true;
+    BeginLevelHistory(sim);
+    levelNotificationTimer = 3.0f;
+    ResetEffects();
+    return true;
 }
 
-int main(void) {
+int main(int argc, char *argv[]) {
     // 1. Initialization
     const int screenWidth = 800;
     const int screenHeight = 600;
-    InitWindow(screenWidth, screenHeight, "Smash Out! - Play to Win!");
-    InitAudioDevice();
 
     // Game state
     GameState gameState = MENU;
-    int score = 0;
-    int lives = 3;
+
+    // Gameplay simulation (bricks, balls, paddle, power-ups, score, lives)
+    static SimState sim;
+
+    // Command line: "--seed N" replays the games of seed N (a fresh seed is picked for
+    // every game otherwise); stress options: "--board 200x200" plays every level on a
+    // board of that size, "--balls 5000" starts every level with that many balls in
+    // massive-multiball mode; "--autopilot" lets the autopilot play every game (soak tests);
+    // "--fps N" caps the frame rate at N (0 = uncapped) instead of a settings preset;
+    // "--scale N" renders at N% of the 800x600 canvas (50-200);
+    // "--render-test DIR" runs the headless render test against the golden images in DIR
+    bool fixedSeed = false;
+    bool autopilotGames = false;
+    const char *renderTestDir = NULL;
+    sim.config.seed = (uint64_t)time(NULL);
+    for (int i = 1; i < argc; i++) {
+        int cols, rows;
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--autopilot") == 0) {
+            autopilotGames = true;
+        } else if (hasValue && strcmp(argv[i], "--seed") == 0) {
+            sim.config.seed = strtoull(argv[i + 1], NULL, 10);
+            fixedSeed = true;
+        } else if (hasValue && strcmp(argv[i], "--board") == 0 && sscanf(argv[i + 1], "%dx%d", &cols, &rows) == 2) {
+            sim.config.customBoard = MakeFittedLayout(cols, rows);
+        } else if (hasValue && strcmp(argv[i], "--balls") == 0) {
+            sim.config.massiveMultiball = true;
+            sim.config.startBalls = atoi(argv[i + 1]);
+        } else if (hasValue && strcmp(argv[i], "--fps") == 0) {
+            customFrameCap.fps = atoi(argv[i + 1]);
+            if (customFrameCap.fps < 0) customFrameCap.fps = 0;
+            if (customFrameCap.fps > 0) {
+                sprintf_s(customFrameCapLabel, sizeof(customFrameCapLabel), "%d FPS", customFrameCap.fps);
+                customFrameCap.label = customFrameCapLabel;
+            } else {
+                customFrameCap.label = "UNCAPPED";
+            }
+            frameCapIndex = -1;
+        } else if (hasValue && strcmp(argv[i], "--scale") == 0) {
+            renderScalePercent = atoi(argv[i + 1]);
+            if (renderScalePercent < MIN_RENDER_SCALE) renderScalePercent = MIN_RENDER_SCALE;
+            if (renderScalePercent > MAX_RENDER_SCALE) renderScalePercent = MAX_RENDER_SCALE;
+        } else if (hasValue && strcmp(argv[i], "--render-test") == 0) {
+            renderTestDir = argv[i + 1];
+        }
+    }
+    bool renderTest = renderTestDir != NULL;
+    if (renderTest && !fixedSeed) {
+        sim.config.seed = RENDER_TEST_SEED;
+        fixedSeed = true;
+    }
+    uint64_t fixedSeedValue = sim.config.seed;
+
+    // The window can take any size; the 800x600 canvas is scaled to fit it
+    SetConfigFlags(renderTest ? FLAG_WINDOW_HIDDEN : FLAG_WINDOW_RESIZABLE);
+    InitWindow(screenWidth, screenHeight, "Smash Out! - Play to Win!");
+    SetWindowMinSize(screenWidth / 4, screenHeight / 4);
+    InitAudioDevice();
+    InitBrickPalette();
+
+    // Autopilot for demo games and --autopilot
+    static Autopilot autopilot;
+    bool demoMode = false;
+    float menuIdleTimer = 0.0f;
+    float demoTimer = 0.0f;
+    SeedRng(&effectsRng, sim.config.seed, RNG_STREAM_COSMETIC);
+    if (!StartGame(&sim)) {
+        TraceLog(LOG_ERROR, "Failed to allocate the brick field");
+        CloseAudioDevice();
+        CloseWindow();
+        return 1;
+    }
+    SimEventList simEvents = { 0 };
+
+    // A trail for every ball slot the game can use
+    if (!InitBallTrails(&ballTrails, sim.ballLimit)) {
+        TraceLog(LOG_WARNING, "Failed to allocate ball trails, trails are disabled");
+    }
+    if (!InitSimMotion(&simMotion, sim.ballLimit)) {
+        TraceLog(LOG_WARNING, "Failed to allocate ball motion, balls are drawn without interpolation");
+    }
 
     // Load menu music
     Music menuMusic = LoadMusicStream("src/resources/Wav/Goblin_Tinker_Soldier_Spy.mp3");
     menuMusic.looping = true;
     bool menuMusicPlaying = false;
 
-    // Load brick hit sound
-    Sound brickHitSound = LoadSound("src/resources/Wav/mixkit-retro-game-notification-212.wav");
-
-    // Load wall hit sound
-    Sound wallHitSound = LoadSound("src/resources/Wav/mixkit-gym-ball-hitting-the-ground-2079.wav");
+    // Load sound effects: voices each, priority for the shared voice budget, and the
+    // window in which repeats merge into one sound (missing files just stay silent)
+    static SoundMixer soundMixer;
+    LoadGameSound(&soundMixer, SOUND_BRICK_HIT, "src/resources/Wav/mixkit-retro-game-notification-212.wav", 4, 0, 0.04f);
+    LoadGameSound(&soundMixer, SOUND_WALL_HIT, "src/resources/Wav/mixkit-gym-ball-hitting-the-ground-2079.wav", 3, 0, 0.04f);
+    LoadGameSound(&soundMixer, SOUND_PADDLE_HIT, "src/resources/Wav/mixkit-catching-a-basketball-ball-2081.wav", 2, 1, 0.05f);
+    LoadGameSound(&soundMixer, SOUND_LOSE_HEART, "src/resources/Wav/mixkit-failure-arcade-alert-notification-240.wav", 2, 2, 0.2f);
+    LoadGameSound(&soundMixer, SOUND_GAME_OVER, "src/resources/Wav/mixkit-piano-game-over-1941.wav", 1, 3, 1.0f);
 
-    // Load paddle hit sound
-    Sound paddleHitSound = LoadSound("src/resources/Wav/mixkit-catching-a-basketball-ball-2081.wav");
+    // Load high score from file (the render test shows 0, so its images don't depend on it)
+    if (!renderTest) LoadHighScore();
 
-    // Load game over sound
-    Sound gameOverSound = LoadSound("src/resources/Wav/mixkit-piano-game-over-1941.wav");
+    // Menu particles setup
+    Vector2 menuParticles[MAX_PARTICLES];
+    InitializeParticles(menuParticles, MAX_PARTICLES);
 
-    // Load lose heart sound
-    Sound loseHeartSound = LoadSound("src/resources/Wav/mixkit-failure-arcade-alert-notification-240.wav");
+    // The render test runs as fast as it can
+    if (renderTest) {
+        SetTargetFPS(0);
+    } else {
+        ApplyFrameCap(GetFrameCap());
+    }
 
-    // Load high score from file
-    LoadHighScore();
+    // Unsimulated real time carried over between frames
+    float simAccumulator = 0.0f;
 
-    // Paddle setup
-    Rectangle paddle = { screenWidth / 2 - 50, screenHeight - 40, 100, 20 };
-    float paddleSpeed = 8.0f;
-    float paddleBuffTimer = 0.0f;
-    float paddleOriginalWidth = 100.0f;
+    // Rewind history for the current level
+    bool rewinding = false;
+    if (!InitSnapshotRing(&rewindRing, REWIND_ARENA_BYTES, REWIND_MAX_RECORDS, REWIND_KEYFRAME_INTERVAL)) {
+        TraceLog(LOG_WARNING, "Failed to allocate the rewind history, rewind is disabled");
+    }
 
-    // Ball setup
-    Ball balls[MAX_BALLS];
-    for (int i = 0; i < MAX_BALLS; i++) {
-        balls[i].active = false;
-        balls[i].radius = 8.0f;
+    // Initialize particle systems
+    if (!InitializeParticleFields()) {
+        TraceLog(LOG_ERROR, "Failed to allocate particle fields");
+        FreeSimState(&sim);
+        CloseAudioDevice();
+        CloseWindow();
+        return 1;
     }
-    balls[0].active = true;
-    balls[0].position = (Vector2){ screenWidth / 2, screenHeight / 2 };
-    balls[0].speed = (Vector2){ 4.0f, -4.0f };
-    balls[0].radius = 8.0f;
-
-    // Power-ups setup
-    PowerUp powerups[MAX_POWERUPS];
-    for (int i = 0; i < MAX_POWERUPS; i++) {
-        powerups[i].active = false;
+    InitializeFloatingCombos();
+
+    // Pixel-art HUD icons
+    if (!LoadHudIcons()) {
+        TraceLog(LOG_WARNING, "Failed to create the HUD icon atlas");
     }
 
-    // Menu particles setup
-    Vector2 menuParticles[MAX_PARTICLES];
-    InitializeParticles(menuParticles, MAX_PARTICLES);
+    // Retained HUD layer (the HUD is drawn every frame without it)
+    if (!PrepareHudLayer(screenWidth, renderTest ? 100 : renderScalePercent)) {
+        TraceLog(LOG_WARNING, "Failed to create the HUD layer, drawing the HUD every frame");
+    }
+    frameStats.windowStart = GetTime();
+
+    // Virtual canvas every frame is drawn into (the render test reads its frames back
+    // from it, always at 100%)
+    static Canvas canvas;
+
+    // Render test progress through the script
+    int renderTestStep = 0;
+    int renderTestFrame = 0;
+    int renderTestDrawCalls = 0;
+    double renderTestSeconds = 0.0;
+    bool renderTestDone = false;
+    int exitCode = 0;
+    if (renderTest) {
+        if (!PrepareCanvas(&canvas, screenWidth, screenHeight, 100)) {
+            TraceLog(LOG_ERROR, "Failed to create the render test framebuffer");
+            renderTestDone = true;
+            exitCode = 1;
+        }
+        SetMouseOffset(-10 * screenWidth, -10 * screenHeight);  // Keep the pointer off every button
+        printf("Render test: seed %llu, golden images in %s\n", (unsigned long long)sim.config.seed, renderTestDir);
+    }
 
-    // Bricks setup
-    Brick bricks[TOTAL_BRICKS];
-    int brickWidth = 70;
-    int brickHeight = 20;
-    int padding = 10;
+    // Animation clock for cosmetic motion (fixed steps in the render test)
+    float animationTime = 0.0f;
 
-    for (int i = 0; i < TOTAL_BRICKS; i++) {
-        int row = i / BRICKS_WIDE;
-        int col = i % BRICKS_WIDE;
-        
-        bricks[i].rect = (Rectangle){ 
-            col * (brickWidth + padding) + 40, 
-            row * (brickHeight + padding) + 120,  // Start at y=120 for HUD buffer
-            brickWidth, 
-            brickHeight 
-        };
-        bricks[i].active = true;
-        bricks[i].type = BRICK_NORMAL;
-        bricks[i].health = 1;
-        bricks[i].discovered = true;
-    }
+    // 2. Main game loop
+    while (!WindowShouldClose() && !renderTestDone) {
+        renderDrawCalls = 0;
+
+        // Fit the canvas to the window as it is now, before the mouse is read
+        PrepareCanvas(&canvas, screenWidth, screenHeight, renderTest ? 100 : renderScalePercent);
+        if (!renderTest) MapMouseToCanvas(&canvas);
+
+        float frameDelta = renderTest ? RENDER_TEST_FRAME_TIME : GetFrameTime();
+        animationTime += frameDelta;
+
+        // Render test: enter the next scripted screen
+        if (renderTest && renderTestFrame == 0) {
+            const RenderTestStep *step = &renderTestSteps[renderTestStep];
+            SeedRng(&effectsRng, sim.config.seed, RNG_STREAM_COSMETIC);
+            demoMode = false;
+            if (step->state == PLAYING) {
+                // A demo game on the fixed seed: the autopilot plays and nothing is recorded
+                if (!StartGame(&sim)) {
+                    TraceLog(LOG_ERROR, "Failed to allocate the brick field");
+                    exitCode = 1;
+                    break;
+                }
+                BeginLevelHistory(&sim);
+                ResetAutopilot(&autopilot);
+                demoMode = true;
+                demoTimer = 0.0f;
+                levelNotificationTimer = 3.0f;
+                ResetEffects();
+                simAccumulator = 0.0f;
+            }
+            levelSummaryTimer = LEVEL_SUMMARY_DURATION;
+            menuIdleTimer = 0.0f;
+            gameState = step->state;
+        }
 
-    SetTargetFPS(60);
+        bool anyInput = GetKeyPressed() != 0 || IsMouseButtonPressed(MOUSE_BUTTON_LEFT) ||
+                        GetMouseDelta().x != 0.0f || GetMouseDelta().y != 0.0f;
 
-    // Initialize particle systems
-    InitializeBrickParticles();
-    InitializeDeathParticles();
-    InitializeFloatingCombos();
+        // Frame stats overlay
+        if (IsKeyPressed(KEY_F3)) frameStats.visible = !frameStats.visible;
+        if (IsKeyPressed(KEY_F4)) frameStats.immediateHud = !frameStats.immediateHud;
 
-    // Heart pixel pattern
-    static const int heartPattern[6][7] = {
-        {0, 1, 1, 0, 1, 1, 0}, // Row 0:  XX   XX
-        {1, 1, 1, 1, 1, 1, 1}, // Row 1: XXXXXXX
-        {1, 1, 1, 1, 1, 1, 1}, // Row 2: XXXXXXX
-        {0, 1, 1, 1, 1, 1, 0}, // Row 3:  XXXXX
-        {0, 0, 1, 1, 1, 0, 0}, // Row 4:   XXX
-        {0, 0, 0, 1, 0, 0, 0}  // Row 5:    X
-    };
+        // Any input (or running out of time) ends a demo game
+        if (demoMode && gameState != MENU) {
+            demoTimer += frameDelta;
+            if (anyInput || demoTimer > ATTRACT_LENGTH) {
+                demoMode = false;
+                menuIdleTimer = 0.0f;
+                gameState = MENU;
+            }
+        }
 
-    // 2. Main game loop
-    while (!WindowShouldClose()) {
         // --- MENU STATE ---
         if (gameState == MENU) {
             // Play menu music
@@ -727,250 +899,141 @@ int main(void) {
             UpdateMusicStream(menuMusic);
             
             // Update particles
-            UpdateParticles(menuParticles, MAX_PARTICLES, 0.5f);
+            UpdateParticles(menuParticles, MAX_PARTICLES, 30.0f, frameDelta);
+
+            // Attract mode: start a demo game after a while without input
+            menuIdleTimer = anyInput ? 0.0f : menuIdleTimer + frameDelta;
+            if (menuIdleTimer > ATTRACT_DELAY) {
+                StopMusicStream(menuMusic);
+                menuMusicPlaying = false;
+                sim.config.seed = ((uint64_t)NextRandom(&effectsRng) << 32) | NextRandom(&effectsRng);
+                if (!StartGame(&sim)) {
+                    TraceLog(LOG_ERROR, "Failed to allocate the brick field");
+                    exitCode = 1;
+                    break;
+                }
+                BeginLevelHistory(&sim);
+                ResetAutopilot(&autopilot);
+                demoMode = true;
+                demoTimer = 0.0f;
+                levelNotificationTimer = 3.0f;
+                ResetEffects();
+                simAccumulator = 0.0f;
+                gameState = PLAYING;
+            }
         }
         // --- PLAYING STATE ---
         else if (gameState == PLAYING) {
-            // Update level timer
-            levelTimer += GetFrameTime();
-
-            // Update combo display timer
-            if (comboDisplayTimer > 0.0f) {
-                comboDisplayTimer -= GetFrameTime();
-            }
-
-            // Update level notification timer
-            if (levelNotificationTimer > 0.0f) {
-                levelNotificationTimer -= GetFrameTime();
-            }
-
-            // Update screen shake
-            if (shakeTimer > 0.0f) {
-                shakeTimer -= GetFrameTime();
-            }
-
-            // Update brick particles
-            UpdateBrickParticles(GetFrameTime());
-
-            // Update paddle buff timer
-            if (paddleBuffTimer > 0.0f) {
-                paddleBuffTimer -= GetFrameTime();
-                if (paddleBuffTimer <= 0.0f) {
-                    paddle.width = paddleOriginalWidth;
-                    paddleBuffTimer = 0.0f;
+            // Accumulate real time and run the simulation in fixed SIM_DT ticks
+            float frameTime = frameDelta;
+            if (frameTime > MAX_FRAME_TIME) frameTime = MAX_FRAME_TIME;
+            simAccumulator += frameTime;
+
+            // Sample input once per rendered frame so every tick in this frame sees the same keys
+            SimInput input = { 0 };
+            if (IsKeyDown(KEY_LEFT)) input.buttons |= SIM_INPUT_LEFT;
+            if (IsKeyDown(KEY_RIGHT)) input.buttons |= SIM_INPUT_RIGHT;
+            rewinding = IsKeyDown(KEY_R) && rewindRing.count > 1;
+
+            while (simAccumulator >= SIM_DT && gameState == PLAYING) {
+                simAccumulator -= SIM_DT;
+                CaptureSimMotion(&simMotion, &sim);
+
+                // Holding R runs the level backwards through the snapshot history
+                if (rewinding) {
+                    int back = (rewindRing.count - 1 < REWIND_SPEED) ? rewindRing.count - 1 : REWIND_SPEED;
+                    if (back > 0 && RestoreSnapshot(&rewindRing, back, &sim)) {
+                        TruncateReplay(&gameReplay, (uint32_t)sim.tick);
+                    }
+                    ResetEffects();
+                    continue;
                 }
-            }
-
-            // Update paddle squash timer
-            if (paddleSquashTimer > 0.0f) {
-                paddleSquashTimer -= GetFrameTime();
-            }
-
-            // Move Paddle
-            if (IsKeyDown(KEY_LEFT) && paddle.x > 0) paddle.x -= paddleSpeed;
-            if (IsKeyDown(KEY_RIGHT) && paddle.x < screenWidth - paddle.width) paddle.x += paddleSpeed;
 
-            // Update and draw balls
-            for (int b = 0; b < MAX_BALLS; b++) {
-                if (!balls[b].active) continue;
-
-                // Move Ball
-                balls[b].position.x += balls[b].speed.x;
-                balls[b].position.y += balls[b].speed.y;
+                // The autopilot decides every tick, from the state it is about to advance
+                SimInput tickInput = (demoMode || autopilotGames) ? GetAutopilotInput(&autopilot, &sim) : input;
+                StepSimulation(&sim, tickInput, &simEvents);
+                if (!demoMode) RecordReplayTick(&gameReplay, tickInput, &sim);
+                double snapshotStart = GetTime();
+                CaptureSnapshot(&rewindRing, &sim);
+                frameStats.snapshotSeconds += GetTime() - snapshotStart;
+                frameStats.snapshots++;
+                RecordBallTrails(&ballTrails, &sim);
+
+                if (simEvents.dropped > 0) TraceLog(LOG_WARNING, "Out of memory: %d events lost", simEvents.dropped);
+
+                // Turn simulation events into sound and visual feedback
+                for (int e = 0; e < simEvents.count; e++) {
+                    const SimEvent *event = &simEvents.events[e];
+                    switch (event->type) {
+                        case SIM_EVENT_WALL_HIT:
+                            QueueSound(&soundMixer, SOUND_WALL_HIT);
+                            break;
 
-                // Ball Collision: Walls
-                if (balls[b].position.x >= screenWidth - balls[b].radius || balls[b].position.x <= balls[b].radius) {
-                    balls[b].speed.x *= -1.0f;
-                    PlaySound(wallHitSound);
-                }
-                if (balls[b].position.y <= balls[b].radius) {
-                    balls[b].speed.y *= -1.0f;
-                    PlaySound(wallHitSound);
-                }
-                
-                // Ball Collision: Paddle
-                if (CheckCollisionCircleRec(balls[b].position, balls[b].radius, paddle)) {
-                    balls[b].speed.y *= -1.0f;
-                    balls[b].position.y = paddle.y - balls[b].radius;
-                    
-                    // Add horizontal velocity based on where ball hits paddle
-                    float hitPos = (balls[b].position.x - paddle.x) / paddle.width;
-                    balls[b].speed.x = (hitPos - 0.5f) * 8.0f;
-                    PlaySound(paddleHitSound);
-                    
-                    // Add juice effects
-                    TriggerScreenShake(1.5f);
-                    paddleSquashTimer = PADDLE_SQUASH_DURATION;
-                    
-                    // Reset combo when ball touches paddle
-                    brickCombo = 0;
-                    comboMultiplier = 1.0f;
-                }
+                        case SIM_EVENT_PADDLE_HIT:
+                            QueueSound(&soundMixer, SOUND_PADDLE_HIT);
+                            TriggerScreenShake(1.5f);
+                            paddleSquashTimer = PADDLE_SQUASH_DURATION;
+                            break;
 
-                // Ball Collision: Bricks
-                for (int i = 0; i < TOTAL_BRICKS; i++) {
-                    if (bricks[i].active) {
-                        if (CheckCollisionCircleRec(balls[b].position, balls[b].radius, bricks[i].rect)) {
-                            balls[b].speed.y *= -1.0f;
-                            PlaySound(brickHitSound);
-                            
-                            // Juice effects
+                        case SIM_EVENT_BRICK_HIT:
+                            QueueSound(&soundMixer, SOUND_BRICK_HIT);
                             TriggerScreenShake(1.0f);
-                            SpawnBrickParticles((Vector2){bricks[i].rect.x + bricks[i].rect.width / 2, 
-                                                           bricks[i].rect.y + bricks[i].rect.height / 2}, 8);
-                            
-                            // Update combo
-                            brickCombo++;
-                            comboMultiplier = 1.0f + (brickCombo - 1) * 0.5f;  // 1.0x, 1.5x, 2.0x, etc.
-                            if (comboMultiplier > 3.0f) comboMultiplier = 3.0f;  // Cap at 3x
+                            SpawnBrickParticles(ToVector2(event->position), 8);
                             comboDisplayTimer = 1.5f;  // Display combo for 1.5 seconds
-                            
+
                             // Spawn floating combo text at brick center if combo > 1
-                            if (brickCombo > 1) {
-                                Vector2 brickCenter = {bricks[i].rect.x + bricks[i].rect.width / 2, 
-                                                       bricks[i].rect.y + bricks[i].rect.height / 2};
-                                SpawnFloatingCombo(brickCenter, comboMultiplier);
-                            }
-                            
-                            int scoreGain = 10;
-                            
-                            // Handle brick types
-                            switch (bricks[i].type) {
-                                case BRICK_NORMAL:
-                                    bricks[i].active = false;
-                                    bricksSmashed++;
-                                    break;
-                                    
-                                case BRICK_TOUGH:
-                                    bricks[i].health--;
-                                    if (bricks[i].health <= 0) {
-                                        bricks[i].active = false;
-                                        bricksSmashed++;
-                                        scoreGain = 30;  // More points for tough bricks
-                                    } else {
-                                        scoreGain = 5;  // Partial points for damage
-                                    }
-                                    break;
-                                    
-                                case BRICK_EXPLOSIVE:
-                                    bricks[i].active = false;
-                                    bricksSmashed++;
-                                    DestroyAdjacentBricks(bricks, i, &scoreGain);
-                                    scoreGain += 20;  // Base points + adjacent bonuses
-                                    break;
-                                    
-                                case BRICK_SPEED:
-                                    bricks[i].active = false;
-                                    bricksSmashed++;
-                                    // Increase ball speed permanently for this level
-                                    balls[b].speed.x *= 1.2f;
-                                    balls[b].speed.y *= 1.2f;
-                                    scoreGain = 25;
-                                    break;
-                                    
-                                case BRICK_INVISIBLE:
-                                    bricks[i].discovered = true;  // Reveal it
-                                    if (bricks[i].discovered) {
-                                        bricks[i].active = false;  // Actually destroy it next hit
-                                        bricksSmashed++;
-                                        scoreGain = 15;  // Points for discovery and destruction
-                                    } else {
-                                        scoreGain = 5;  // Points for discovery
-                                    }
-                                    break;
-                                    
-                                default:
-                                    bricks[i].active = false;
-                                    bricksSmashed++;
-                            }
-                            
-                            // Apply combo multiplier to score
-                            score += (int)(scoreGain * comboMultiplier);
-                            
-                            // 20% chance to spawn power-up (except from tough with health > 0)
-                            if ((rand() % 100) < POWERUP_SPAWN_CHANCE) {
-                                SpawnPowerUp(powerups, (int)(bricks[i].rect.x + bricks[i].rect.width / 2), (int)bricks[i].rect.y);
+                            if (event->combo > 1) {
+                                SpawnFloatingCombo(ToVector2(event->position), event->multiplier);
                             }
                             break;
-                        }
-                    }
-                }
 
-                // Reset ball if it falls off screen - spawn death particles
-                if (balls[b].position.y > screenHeight) {
-                    SpawnDeathParticles(balls[b].position);
-                    balls[b].active = false;
-                }
-            }
+                        case SIM_EVENT_BRICK_EXPLODED:
+                            QueueSound(&soundMixer, SOUND_BRICK_HIT);
+                            TriggerScreenShake(2.0f);
+                            SpawnBrickParticles(ToVector2(event->position), 8);
+                            break;
 
-            // Update death particles
-            UpdateDeathParticles(GetFrameTime());
-            
-            // Update floating combo text
-            UpdateFloatingCombos(GetFrameTime());
+                        case SIM_EVENT_BALL_LOST:
+                            SpawnDeathParticles(ToVector2(event->position));
+                            break;
 
-            // Check if all balls are gone
-            bool anyBallActive = false;
-            for (int i = 0; i < MAX_BALLS; i++) {
-                if (balls[i].active) {
-                    anyBallActive = true;
-                    break;
-                }
-            }
-            
-            if (!anyBallActive) {
-                lives--;
-                if (lives <= 0) {
-                    PlaySound(gameOverSound);
-                    gameState = GAME_OVER;
-                } else {
-                    PlaySound(loseHeartSound);
-                    balls[0].active = true;
-                    balls[0].position = (Vector2){ screenWidth / 2, screenHeight / 2 };
-                    balls[0].speed = (Vector2){ 4.0f, -4.0f };
+                        case SIM_EVENT_LIFE_LOST:
+                            QueueSound(&soundMixer, SOUND_LOSE_HEART);
+                            break;
+
+                        case SIM_EVENT_POWERUP_COLLECTED:
+                            if (event->index == EXTRA_LIFE) {
+                                QueueSound(&soundMixer, SOUND_LOSE_HEART);  // Reusing sound; can use different if needed
+                            }
+                            break;
+
+                        default:
+                            break;
+                    }
                 }
-            }
 
-            // Update power-ups
-            for (int i = 0; i < MAX_POWERUPS; i++) {
-                if (!powerups[i].active) continue;
-
-                // Fall downward
-                powerups[i].rect.y += POWERUP_SPEED;
-
-                // Check collision with paddle
-                if (CheckCollisionRecs(powerups[i].rect, paddle)) {
-                    powerups[i].active = false;
-
-                    // Apply power-up effect
-                    if (powerups[i].type == MULTIBALL) {
-                        // Spawn a second ball
-                        SpawnBall(balls, balls[0].position, balls[0].speed);
-                    } else if (powerups[i].type == WIDE_PADDLE) {
-                        paddle.width = paddleOriginalWidth * 2.0f;
-                        paddleBuffTimer = 10.0f;
-                    } else if (powerups[i].type == SCREEN_WIDE) {
-                        paddle.width = screenWidth;
-                        paddle.x = 0;
-                        paddleBuffTimer = 5.0f;
-                    } else if (powerups[i].type == EXTRA_LIFE) {
-                        if (lives < 5) lives++;  // Cap at 5 lives max
-                        PlaySound(loseHeartSound);  // Reusing sound; can use different if needed
+                // Leave PLAYING from the sim's status rather than its events, which can be dropped
+                if (sim.status == SIM_LEVEL_CLEARED) {
+                    // All bricks destroyed - show level summary
+                    levelSummaryTimer = LEVEL_SUMMARY_DURATION;
+                    gameState = LEVEL_SUMMARY;
+                } else if (sim.status == SIM_GAME_OVER) {
+                    if (demoMode) {
+                        // The demo just ends
+                        demoMode = false;
+                        menuIdleTimer = 0.0f;
+                        gameState = MENU;
+                    } else {
+                        QueueSound(&soundMixer, SOUND_GAME_OVER);
+                        SaveGameReplay();
+                        gameState = GAME_OVER;
                     }
-                } else if (powerups[i].rect.y > screenHeight) {
-                    // Power-up fell off screen
-                    powerups[i].active = false;
                 }
-            }
 
-            // Check win condition
-            if (CountActiveBricksInLevel(bricks) == 0) {
-                // All bricks destroyed - show level summary
-                levelCompletionTime = levelTimer;
-                levelSummaryTimer = LEVEL_SUMMARY_DURATION;
-                gameState = LEVEL_SUMMARY;
+                // Cosmetic effects advance on the same fixed tick
+                UpdateEffects(SIM_DT);
             }
-            
+
             // Pause on P or ESC
             if (IsKeyPressed(KEY_P) || IsKeyPressed(KEY_ESCAPE)) {
                 gameState = PAUSED;
@@ -983,37 +1046,32 @@ int main(void) {
                 gameState = PLAYING;
             }
             // Quit to menu on Q
+            // (StartGame resets the whole simulation when a new game begins)
             if (IsKeyPressed(KEY_Q)) {
+                SaveGameReplay();
                 gameState = MENU;
-                brickCombo = 0;
-                comboMultiplier = 1.0f;
-                levelTimer = 0.0f;
-                score = 0;
-                lives = 3;
+            }
+            // Restart the level on R
+            if (IsKeyPressed(KEY_R) && RestartLevel(&sim)) {
+                simAccumulator = 0.0f;
+                gameState = PLAYING;
             }
         }
         // --- LEVEL SUMMARY STATE ---
         else if (gameState == LEVEL_SUMMARY) {
             if (levelSummaryTimer > 0.0f) {
-                levelSummaryTimer -= GetFrameTime();
-            } else if (IsKeyPressed(KEY_SPACE)) {
-                // Move to next level
-                currentLevel++;
-                levelNotificationTimer = 2.0f;
-                levelTimer = 0.0f;
-                LoadLevel(currentLevel, bricks, balls);
-                paddle.x = screenWidth / 2 - 50;
-                paddle.width = paddleOriginalWidth;
-                paddleBuffTimer = 0.0f;
-                brickCombo = 0;
-                comboMultiplier = 1.0f;
-                bricksSmashed = 0;
-                
-                // Clear power-ups for new level
-                for (int i = 0; i < MAX_POWERUPS; i++) {
-                    powerups[i].active = false;
+                levelSummaryTimer -= frameDelta;
+            } else if (IsKeyPressed(KEY_SPACE) || demoMode || autopilotGames) {
+                // Move to next level (resets board, balls, paddle, power-ups and combo)
+                if (!LoadLevel(&sim, sim.level + 1)) {
+                    TraceLog(LOG_ERROR, "Failed to allocate the brick field");
+                    exitCode = 1;
+                    break;
                 }
-                
+                BeginLevelHistory(&sim);
+                levelNotificationTimer = 3.0f;
+                ResetEffects();
+                simAccumulator = 0.0f;
                 gameState = PLAYING;
             }
         }
@@ -1021,11 +1079,16 @@ int main(void) {
         else if (gameState == GAME_OVER) {
             if (IsKeyPressed(KEY_SPACE)) {
                 // Update high score and reset game state
-                UpdateHighScore(score);
+                UpdateHighScore(sim.score);
                 gameState = MENU;
-                brickCombo = 0;
-                comboMultiplier = 1.0f;
-                levelTimer = 0.0f;
+            }
+            // Retry the level on R
+            if (IsKeyPressed(KEY_R)) {
+                UpdateHighScore(sim.score);
+                if (RestartLevel(&sim)) {
+                    simAccumulator = 0.0f;
+                    gameState = PLAYING;
+                }
             }
         }
         // --- WIN STATE ---
@@ -1051,14 +1114,43 @@ int main(void) {
                 }
             }
             
+            // Frame rate and render scale with the arrow keys (the buttons cycle them too)
+            if (IsKeyPressed(KEY_LEFT)) CycleFrameCap(-1);
+            if (IsKeyPressed(KEY_RIGHT)) CycleFrameCap(1);
+            if (IsKeyPressed(KEY_DOWN)) CycleRenderScale(-1);
+            if (IsKeyPressed(KEY_UP)) CycleRenderScale(1);
+
             // Back to menu
             if (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_SPACE)) {
                 gameState = MENU;
             }
         }
 
+        // Start this frame's sounds, merged and within the voice budget
+        PlayQueuedSounds(&soundMixer, GetTime());
+
         // --- DRAW ---
-        BeginDrawing();
+        double renderStart = GetTime();
+
+        // Bring the HUD layer up to date before the frame starts (texture mode can't nest in it)
+        bool retainedHud = gameState == PLAYING && !frameStats.immediateHud &&
+                           PrepareHudLayer(screenWidth, canvas.scalePercent);
+        double hudStart = GetTime();
+        if (retainedHud) {
+            int redrawCalls = UpdateHudLayer(&sim, screenWidth);
+            frameStats.hudDrawCalls += redrawCalls;
+            if (redrawCalls > 0) frameStats.hudRedraws++;
+        }
+        frameStats.hudSeconds += GetTime() - hudStart;
+
+        // Same for the brick layer (the field is drawn directly if the layer is unavailable)
+        bool brickLayerReady = false;
+        if (gameState == PLAYING) {
+            brickLayerReady = UpdateBrickLayer(&brickLayer, &sim.bricks, canvas.scalePercent);
+            frameStats.brickRedraws += brickLayer.redrawn;
+        }
+
+        BeginCanvasFrame(&canvas);
         ClearBackground(BLACK);
 
         if (gameState == MENU) {
@@ -1066,18 +1158,17 @@ int main(void) {
             DrawParticles(menuParticles, MAX_PARTICLES, DARKBLUE);
             
             // Draw animated title with bob effect and shadow
-            float bobOffset = sinf((float)GetTime() * 3.0f) * 15.0f;
+            float bobOffset = sinf(animationTime * 3.0f) * 15.0f;
             int titleY = 80 + (int)bobOffset;
             DrawTextWithShadow("SMASH OUT!", screenWidth / 2 - 150, titleY, 60, YELLOW);
             
-            // Draw high score
-            char hsDisplay[40];
-            sprintf_s(hsDisplay, sizeof(hsDisplay), "High Score: %d", highScore);
-            int hsWidth = MeasureText(hsDisplay, 20);
-            DrawTextWithShadow(hsDisplay, screenWidth / 2 - hsWidth / 2, 160, 20, ORANGE);
+            // Draw high sim.score
+            static CachedText hsDisplay;
+            FormatCachedText(&hsDisplay, highScore, 20, "High Score: %d", highScore);
+            DrawTextWithShadow(hsDisplay.text, screenWidth / 2 - hsDisplay.width / 2, 160, 20, ORANGE);
             
             // Draw subtitle
-            DrawText("Click to Play or Press SPACE", screenWidth / 2 - 160, 180, 20, LIGHTGRAY);
+            DrawTextCounted("Click to Play or Press SPACE", screenWidth / 2 - 160, 180, 20, LIGHTGRAY);
             
             // Button handling and drawing
             // Start button
@@ -1085,15 +1176,25 @@ int main(void) {
             if (DrawButton(startButton, "START", 30, BLUE, SKYBLUE)) {
                 StopMusicStream(menuMusic);
                 menuMusicPlaying = false;
+                simAccumulator = 0.0f;
                 gameState = PLAYING;
-                currentLevel = 1;
-                levelNotificationTimer = 0.0f;
-                LoadLevel(currentLevel, bricks, balls);
-                score = 0;
-                lives = 3;
-                paddleBuffTimer = 0.0f;
-                paddle.x = screenWidth / 2 - 50;
-                paddle.width = paddleOriginalWidth;
+                if (fixedSeed) {
+                    sim.config.seed = fixedSeedValue;
+                } else {
+                    sim.config.seed = ((uint64_t)NextRandom(&effectsRng) << 32) | NextRandom(&effectsRng);
+                }
+                TraceLog(LOG_INFO, "GAME: Seed %llu", (unsigned long long)sim.config.seed);
+                if (!StartGame(&sim)) {
+                    TraceLog(LOG_ERROR, "Failed to allocate the brick field");
+                    exitCode = 1;
+                    break;
+                }
+                ResetAutopilot(&autopilot);
+                BeginReplay(&gameReplay, &sim, REPLAY_HASH_INTERVAL);
+                replayUnsaved = true;
+                BeginLevelHistory(&sim);
+                levelNotificationTimer = 3.0f;
+                ResetEffects();
             }
             
             // Settings button
@@ -1119,181 +1220,102 @@ int main(void) {
             float shakeOffsetX = 0.0f;
             float shakeOffsetY = 0.0f;
             if (shakeTimer > 0.0f) {
-                shakeOffsetX = (float)((rand() % 100 - 50) / 50.0f * shakeIntensity);
-                shakeOffsetY = (float)((rand() % 100 - 50) / 50.0f * shakeIntensity);
+                shakeOffsetX = (float)((RandomInt(&effectsRng, 100) - 50) / 50.0f * shakeIntensity);
+                shakeOffsetY = (float)((RandomInt(&effectsRng, 100) - 50) / 50.0f * shakeIntensity);
             }
             
-            // Draw Bricks
-            for (int i = 0; i < TOTAL_BRICKS; i++) {
-                if (bricks[i].active) {
-                    Rectangle shakeBrick = bricks[i].rect;
-                    shakeBrick.x += shakeOffsetX;
-                    shakeBrick.y += shakeOffsetY;
-                    DrawRectangleRec(shakeBrick, GetBrickColor(bricks[i]));
-                    DrawRectangleLines((int)shakeBrick.x, (int)shakeBrick.y, 
-                                     (int)shakeBrick.width, (int)shakeBrick.height, BLACK);
-                } else if (bricks[i].type == BRICK_INVISIBLE && !bricks[i].discovered && bricks[i].rect.x > 0) {
-                    // Draw undiscovered invisible bricks as a faint outline
-                    Rectangle shakeBrick = bricks[i].rect;
-                    shakeBrick.x += shakeOffsetX;
-                    shakeBrick.y += shakeOffsetY;
-                    DrawRectangleLines((int)shakeBrick.x, (int)shakeBrick.y, 
-                                     (int)shakeBrick.width, (int)shakeBrick.height, (Color){100, 100, 100, 80});
-                }
+            // Draw Bricks (one textured quad, or one batch for the whole field)
+            Vector2 shakeOffset = { shakeOffsetX, shakeOffsetY };
+            if (brickLayerReady) {
+                DrawBrickLayer(&brickLayer, shakeOffset);
+            } else {
+                DrawBrickField(&sim.bricks, shakeOffset);
             }
 
-            // Draw Balls with trail
-            for (int i = 0; i < MAX_BALLS; i++) {
-                if (balls[i].active) {
-                    // Draw ball trail (semi-transparent circles behind ball)
-                    for (int t = 1; t <= 4; t++) {
-                        float trailAlpha = (1.0f - (float)t / 4.0f) * 0.5f;  // Fade effect
-                        Vector2 trailPos = {
-                            balls[i].position.x - balls[i].speed.x * t * 0.1f + shakeOffsetX,
-                            balls[i].position.y - balls[i].speed.y * t * 0.1f + shakeOffsetY
-                        };
-                        DrawCircleV(trailPos, balls[i].radius * 0.6f, (Color){255, 255, 255, (unsigned char)(150 * trailAlpha)});
-                    }
+            // Moving things are drawn between the last two ticks, by the time not yet simulated
+            float motionAlpha = simAccumulator / SIM_DT;
+
+            // Draw ball trails (one batch for every ball)
+            DrawBallTrails(&ballTrails, &sim, motionAlpha, shakeOffset);
+
+            // Draw Balls (combo text only on the first few in massive multiball)
+            for (int i = 0; i < sim.ballCount; i++) {
+                Vector2 ballPos = GetBallDrawPosition(&simMotion, &sim, i, motionAlpha);
+                DrawCircleVCounted((Vector2){ballPos.x + shakeOffsetX, ballPos.y + shakeOffsetY}, 
+                           sim.balls[i].radius, WHITE);
+
+                // Draw floating combo message above ball (if active)
+                if (i < MAX_BALLS && comboDisplayTimer > 0.0f && sim.brickCombo > 1) {
+                    float fadeAlpha = comboDisplayTimer / 1.5f;  // Fade out
+                    float floatOffset = (1.5f - comboDisplayTimer) * 30.0f;  // Rise upward
                     
-                    // Draw ball
-                    DrawCircleV((Vector2){balls[i].position.x + shakeOffsetX, balls[i].position.y + shakeOffsetY}, 
-                               balls[i].radius, WHITE);
+                    static CachedText comboCache;
+                    int comboTenths = (int)(sim.comboMultiplier * 10.0f + 0.5f);
+                    const char *comboText = FormatCachedText(&comboCache, comboTenths, 24, "COMBO x%d.%d!",
+                                                             comboTenths / 10, comboTenths % 10);
+                    int comboTextWidth = comboCache.width;
                     
-                    // Draw floating combo message above ball (if active)
-                    if (comboDisplayTimer > 0.0f && brickCombo > 1) {
-                        float fadeAlpha = comboDisplayTimer / 1.5f;  // Fade out
-                        float floatOffset = (1.5f - comboDisplayTimer) * 30.0f;  // Rise upward
-                        
-                        char comboText[30];
-                        sprintf_s(comboText, sizeof(comboText), "COMBO x%.1f!", comboMultiplier);
-                        int comboTextWidth = MeasureText(comboText, 24);
-                        
-                        Vector2 comboPos = {
-                            balls[i].position.x + shakeOffsetX - comboTextWidth / 2,
-                            balls[i].position.y + shakeOffsetY - 50 - floatOffset
-                        };
-                        
-                        Color comboColor = (Color){255, 165, 0, (unsigned char)(255 * fadeAlpha)};
-                        DrawText(comboText, (int)comboPos.x + 1, (int)comboPos.y + 1, 24, (Color){0, 0, 0, (unsigned char)(150 * fadeAlpha)});
-                        DrawText(comboText, (int)comboPos.x, (int)comboPos.y, 24, comboColor);
-                    }
+                    Vector2 comboPos = {
+                        ballPos.x + shakeOffsetX - comboTextWidth / 2,
+                        ballPos.y + shakeOffsetY - 50 - floatOffset
+                    };
+                    
+                    Color comboColor = (Color){255, 165, 0, (unsigned char)(255 * fadeAlpha)};
+                    DrawTextCounted(comboText, (int)comboPos.x + 1, (int)comboPos.y + 1, 24, (Color){0, 0, 0, (unsigned char)(150 * fadeAlpha)});
+                    DrawTextCounted(comboText, (int)comboPos.x, (int)comboPos.y, 24, comboColor);
                 }
             }
 
             // Draw Power-Ups
             for (int i = 0; i < MAX_POWERUPS; i++) {
-                if (powerups[i].active) {
-                    Rectangle shakePowerUp = powerups[i].rect;
+                if (sim.powerups[i].active) {
+                    Rectangle shakePowerUp = GetPowerUpDrawRect(&simMotion, &sim, i, motionAlpha);
                     shakePowerUp.x += shakeOffsetX;
                     shakePowerUp.y += shakeOffsetY;
-                    DrawRectangleRec(shakePowerUp, powerups[i].color);
-                    DrawRectangleLines((int)shakePowerUp.x, (int)shakePowerUp.y, 
+                    DrawRectangleRecCounted(shakePowerUp, GetPowerUpColor(sim.powerups[i].type));
+                    DrawRectangleLinesCounted((int)shakePowerUp.x, (int)shakePowerUp.y, 
                                      (int)shakePowerUp.width, (int)shakePowerUp.height, WHITE);
                 }
             }
 
             // Draw Paddle with squash/stretch effect
-            Rectangle paddleToDraw = paddle;
+            Rectangle paddleToDraw = GetPaddleDrawRect(&simMotion, &sim, motionAlpha);
             paddleToDraw.x += shakeOffsetX;
             paddleToDraw.y += shakeOffsetY;
             
             if (paddleSquashTimer > 0.0f) {
                 float squashAmount = 1.0f - (paddleSquashTimer / PADDLE_SQUASH_DURATION);
                 squashAmount *= 0.2f;  // Max 20% squash
-                paddleToDraw.height = paddle.height * (1.0f - squashAmount);
-                paddleToDraw.width = paddle.width * (1.0f + squashAmount * 0.5f);
-                paddleToDraw.y += paddle.height * squashAmount * 0.5f;
+                paddleToDraw.height = sim.paddle.height * (1.0f - squashAmount);
+                paddleToDraw.width = sim.paddle.width * (1.0f + squashAmount * 0.5f);
+                paddleToDraw.y += sim.paddle.height * squashAmount * 0.5f;
             }
             
-            DrawRectangleRec(paddleToDraw, BLUE);
-            DrawRectangleLines((int)paddleToDraw.x, (int)paddleToDraw.y, (int)paddleToDraw.width, (int)paddleToDraw.height, SKYBLUE);
+            DrawRectangleRecCounted(paddleToDraw, BLUE);
+            DrawRectangleLinesCounted((int)paddleToDraw.x, (int)paddleToDraw.y, (int)paddleToDraw.width, (int)paddleToDraw.height, SKYBLUE);
 
             // Draw particles (explosions, brick destruction)
-            DrawBrickParticles();
+            float particleLag = (1.0f - motionAlpha) * SIM_DT;
+            DrawParticleField(&brickParticles, 3.0f, RED, particleLag);
             
             // Draw death particles
-            DrawDeathParticles();
+            DrawParticleField(&deathParticles, 4.0f, LIGHTGRAY, particleLag);
             
             // Draw floating combo text
+            DrawFloatingCombos();
 
-            // === CLEAN MINIMALIST HUD (y: 0-80) ===
-            
-            // Main HUD Bar Background
-            DrawRectangle(0, 0, screenWidth, 80, Fade((Color){20, 20, 30, 255}, 0.85f));
-            DrawLine(0, 80, screenWidth, 80, (Color){100, 100, 120, 255});
-            
-            // LEFT SECTION: Score and Level
-            DrawTextWithShadow("SCORE", 20, 12, 14, ORANGE);
-            char scoreStr[20];
-            sprintf_s(scoreStr, sizeof(scoreStr), "%d", score);
-            DrawTextWithShadow(scoreStr, 20, 32, 28, YELLOW);
-            
-            DrawTextWithShadow("LEVEL", 130, 12, 14, ORANGE);
-            char levelStr[10];
-            sprintf_s(levelStr, sizeof(levelStr), "%d", currentLevel);
-            DrawTextWithShadow(levelStr, 130, 32, 28, GREEN);
-            
-            // CENTER SECTION: Bricks and Combo
-            char bricksStr[20];
-            sprintf_s(bricksStr, sizeof(bricksStr), "BRICKS: %d", CountActiveBricksInLevel(bricks));
-            int bricksWidth = MeasureText(bricksStr, 18);
-            DrawTextWithShadow(bricksStr, screenWidth / 2 - bricksWidth / 2, 15, 18, SKYBLUE);
-            
-            // Combo display in center
-            if (brickCombo > 1) {
-                char comboStr[20];
-                sprintf_s(comboStr, sizeof(comboStr), "COMBO: %.1fx", comboMultiplier);
-                int comboWidth = MeasureText(comboStr, 18);
-                Color comboColor = (Color){255, 200, 0, 255};  // Golden
-                DrawTextWithShadow(comboStr, screenWidth / 2 - comboWidth / 2, 42, 18, comboColor);
-            }
-            
-            // RIGHT SECTION: Time and Lives
-            // Hearts (Lives) - positioned before time
-            int heartsStartX = screenWidth - 220;
-            int heartsStartY = 48;
-            
-            // Draw hearts first
-            int displayLives = lives > 5 ? 5 : lives;  // Cap at 5 hearts
-            int numHeartsDisplayed = displayLives;
-            
-            char timeStr[20];
-            sprintf_s(timeStr, sizeof(timeStr), "%.1fs", levelTimer);
-            DrawTextWithShadow("TIME", screenWidth - 100, 12, 14, ORANGE);
-            DrawTextWithShadow(timeStr, screenWidth - 100, 32, 24, SKYBLUE);
-            
-            for (int i = 0; i < numHeartsDisplayed; i++) {
-                int baseX = heartsStartX + (i * 28);
-                int baseY = heartsStartY;
-                
-                for (int row = 0; row < 6; row++) {
-                    for (int col = 0; col < 7; col++) {
-                        if (heartPattern[row][col] == 1) {
-                            DrawRectangle(
-                                baseX + (col * 3),
-                                baseY + (row * 3),
-                                3,
-                                3,
-                                RED
-                            );
-                        }
-                    }
-                }
-            }
-            
-            // Buff progress bar (if active)
-            if (paddleBuffTimer > 0.0f) {
-                DrawText("BUFF", heartsStartX - 60, 52, 12, LIME);
-                
-                Rectangle buffBarBg = {heartsStartX - 60, 68, 50, 6};
-                DrawRectangleRec(buffBarBg, DARKGRAY);
-                DrawRectangleLines((int)buffBarBg.x, (int)buffBarBg.y, (int)buffBarBg.width, (int)buffBarBg.height, LIME);
-                
-                float buffProgress = paddleBuffTimer / 10.0f;
-                if (buffProgress > 1.0f) buffProgress = 1.0f;
-                Rectangle buffBarFill = {buffBarBg.x, buffBarBg.y, buffBarBg.width * buffProgress, buffBarBg.height};
-                DrawRectangleRec(buffBarFill, LIME);
+            // HUD bar
+            hudStart = GetTime();
+            int hudDrawStart = renderDrawCalls;
+            if (retainedHud) {
+                DrawHudLayer();
+            } else {
+                HudInputs hud = GetHudInputs(&sim);
+                DrawHudBar(&hud, screenWidth);
+                frameStats.hudRedraws++;
             }
+            frameStats.hudDrawCalls += renderDrawCalls - hudDrawStart;
+            frameStats.hudSeconds += GetTime() - hudStart;
 
             // Level notification (center screen, appears for 3 seconds)
             if (levelNotificationTimer > 0.0f) {
@@ -1301,42 +1323,53 @@ int main(void) {
                 unsigned char alphaValue = (unsigned char)(200 * fadeFactor);
                 
                 // Semi-transparent background box
-                DrawRectangle(screenWidth / 2 - 150, screenHeight / 2 - 60, 300, 120, 
+                DrawRectangleCounted(screenWidth / 2 - 150, screenHeight / 2 - 60, 300, 120, 
                             (Color){0, 0, 0, alphaValue});
-                DrawRectangleLines(screenWidth / 2 - 150, screenHeight / 2 - 60, 300, 120, 
+                DrawRectangleLinesCounted(screenWidth / 2 - 150, screenHeight / 2 - 60, 300, 120, 
                                  (Color){255, 255, 255, alphaValue});
                 
                 // Large level text with fade
-                char levelNotificationText[30];
-                sprintf_s(levelNotificationText, sizeof(levelNotificationText), "LEVEL %d", currentLevel);
-                int notifTextWidth = MeasureText(levelNotificationText, 60);
-                DrawText(levelNotificationText, screenWidth / 2 + 2 - notifTextWidth / 2, screenHeight / 2 - 40, 60, (Color){0, 0, 0, alphaValue});
-                DrawText(levelNotificationText, screenWidth / 2 - notifTextWidth / 2, screenHeight / 2 - 42, 60, (Color){255, 255, 0, (unsigned char)(255 * fadeFactor)});
+                static CachedText notificationCache;
+                const char *levelNotificationText = FormatCachedText(&notificationCache, sim.level, 60, "LEVEL %d", sim.level);
+                int notifTextWidth = notificationCache.width;
+                DrawTextCounted(levelNotificationText, screenWidth / 2 + 2 - notifTextWidth / 2, screenHeight / 2 - 40, 60, (Color){0, 0, 0, alphaValue});
+                DrawTextCounted(levelNotificationText, screenWidth / 2 - notifTextWidth / 2, screenHeight / 2 - 42, 60, (Color){255, 255, 0, (unsigned char)(255 * fadeFactor)});
+            }
+
+            // Demo banner
+            if (demoMode && fmodf(animationTime, 1.0f) < 0.7f) {
+                DrawTextWithShadow("DEMO - PRESS ANY KEY", screenWidth / 2 - 150, screenHeight / 2 + 40, 25, YELLOW);
+            }
+
+            // Rewind indicator
+            if (rewinding) {
+                DrawTextWithShadow("<< REWIND", screenWidth / 2 - 70, screenHeight / 2 + 80, 30, SKYBLUE);
             }
         }
         else if (gameState == GAME_OVER) {
-            DrawText("GAME OVER!", screenWidth / 2 - 150, 150, 60, RED);
-            char finalScore[30];
-            sprintf_s(finalScore, sizeof(finalScore), "Final Score: %d", score);
-            DrawText(finalScore, screenWidth / 2 - 150, 260, 40, YELLOW);
+            DrawTextCounted("GAME OVER!", screenWidth / 2 - 150, 150, 60, RED);
+            static CachedText finalScore;
+            FormatCachedText(&finalScore, sim.score, 40, "Final Score: %d", sim.score);
+            DrawTextCounted(finalScore.text, screenWidth / 2 - 150, 260, 40, YELLOW);
             
-            // Show if new high score
-            if (score >= highScore && score > 0) {
+            // Show if new high sim.score
+            if (sim.score >= highScore && sim.score > 0) {
                 DrawTextWithShadow("NEW HIGH SCORE!", screenWidth / 2 - 140, 320, 30, GOLD);
             } else {
-                char hsText[40];
-                sprintf_s(hsText, sizeof(hsText), "High Score: %d", highScore);
-                DrawText(hsText, screenWidth / 2 - 130, 320, 25, LIGHTGRAY);
+                static CachedText hsText;
+                FormatCachedText(&hsText, highScore, 25, "High Score: %d", highScore);
+                DrawTextCounted(hsText.text, screenWidth / 2 - 130, 320, 25, LIGHTGRAY);
             }
             
-            DrawText("Press SPACE to return to menu", screenWidth / 2 - 200, 420, 25, LIGHTGRAY);
+            DrawTextCounted("Press SPACE to return to menu", screenWidth / 2 - 200, 420, 25, LIGHTGRAY);
+            DrawTextCounted("Press R to retry the level", screenWidth / 2 - 170, 460, 25, LIGHTGRAY);
         }
         else if (gameState == WIN) {
-            DrawText("YOU WIN!", screenWidth / 2 - 150, 200, 60, GREEN);
-            char finalScore[30];
-            sprintf_s(finalScore, sizeof(finalScore), "Final Score: %d", score);
-            DrawText(finalScore, screenWidth / 2 - 150, 320, 40, YELLOW);
-            DrawText("Press SPACE to return to menu", screenWidth / 2 - 200, 420, 25, LIGHTGRAY);
+            DrawTextCounted("YOU WIN!", screenWidth / 2 - 150, 200, 60, GREEN);
+            static CachedText finalScore;
+            FormatCachedText(&finalScore, sim.score, 40, "Final Score: %d", sim.score);
+            DrawTextCounted(finalScore.text, screenWidth / 2 - 150, 320, 40, YELLOW);
+            DrawTextCounted("Press SPACE to return to menu", screenWidth / 2 - 200, 420, 25, LIGHTGRAY);
         }
         else if (gameState == SETTINGS) {
             // Draw title
@@ -1347,35 +1380,52 @@ int main(void) {
             
             // Draw volume slider background
             Rectangle volumeSlider = { 250, 250, 300, 20 };
-            DrawRectangleRec(volumeSlider, DARKGRAY);
-            DrawRectangleLines((int)volumeSlider.x, (int)volumeSlider.y, (int)volumeSlider.width, (int)volumeSlider.height, LIGHTGRAY);
+            DrawRectangleRecCounted(volumeSlider, DARKGRAY);
+            DrawRectangleLinesCounted((int)volumeSlider.x, (int)volumeSlider.y, (int)volumeSlider.width, (int)volumeSlider.height, LIGHTGRAY);
             
             // Draw volume slider fill (progress)
             Rectangle volumeFill = { volumeSlider.x, volumeSlider.y, volumeSlider.width * masterVolume, volumeSlider.height };
-            DrawRectangleRec(volumeFill, LIME);
+            DrawRectangleRecCounted(volumeFill, LIME);
             
             // Draw volume percentage
-            char volumeText[10];
-            sprintf_s(volumeText, sizeof(volumeText), "%d%%", (int)(masterVolume * 100));
-            int volumeTextWidth = MeasureText(volumeText, 20);
-            DrawTextWithShadow(volumeText, screenWidth / 2 - volumeTextWidth / 2, 310, 20, YELLOW);
+            static CachedText volumeText;
+            int volumePercent = (int)(masterVolume * 100);
+            FormatCachedText(&volumeText, volumePercent, 20, "%d%%", volumePercent);
+            DrawTextWithShadow(volumeText.text, screenWidth / 2 - volumeText.width / 2, 310, 20, YELLOW);
+            
+            // Frame rate: the button steps through the caps
+            DrawTextWithShadow("Frame Rate", 250, 347, 25, LIGHTGRAY);
+            Rectangle frameCapButton = { 420, 340, 130, 40 };
+            if (DrawButton(frameCapButton, GetFrameCap().label, 20, SKYBLUE, LIGHTGRAY)) {
+                CycleFrameCap(1);
+            }
+            
+            // Render scale: the button steps through the presets
+            DrawTextWithShadow("Render Scale", 250, 397, 25, LIGHTGRAY);
+            Rectangle renderScaleButton = { 420, 390, 130, 40 };
+            static CachedText renderScaleText;
+            FormatCachedText(&renderScaleText, renderScalePercent, 20, "%d%%", renderScalePercent);
+            if (DrawButton(renderScaleButton, renderScaleText.text, 20, SKYBLUE, LIGHTGRAY)) {
+                CycleRenderScale(1);
+            }
             
             // Draw Back button
-            Rectangle backButton = { screenWidth / 2 - 100, 420, 200, 60 };
+            Rectangle backButton = { screenWidth / 2 - 100, 450, 200, 60 };
             if (DrawButton(backButton, "BACK", 30, ORANGE, YELLOW)) {
                 gameState = MENU;
             }
             
             // Draw hint text
-            DrawText("Click slider to adjust volume or press ESC", screenWidth / 2 - 230, 520, 18, LIGHTGRAY);
+            DrawTextCounted("Click slider to adjust volume or press ESC", screenWidth / 2 - 230, 525, 18, LIGHTGRAY);
+            DrawTextCounted("LEFT/RIGHT: frame rate   UP/DOWN: render scale", screenWidth / 2 - 230, 550, 18, LIGHTGRAY);
         }
         else if (gameState == HOW_TO_PLAY) {
             // Draw How to Play page with card grid layout
-            DrawRectangle(0, 0, screenWidth, screenHeight, (Color){15, 15, 25, 255});
+            DrawRectangleCounted(0, 0, screenWidth, screenHeight, (Color){15, 15, 25, 255});
             
-            // Centered title using MeasureText
+            // Centered title (constant strings, so the widths come from the measurement cache)
             const char* titleText = "HOW TO PLAY";
-            int titleWidth = MeasureText(titleText, 50);
+            int titleWidth = MeasureTextCached(titleText, 50);
             DrawTextWithShadow(titleText, screenWidth / 2 - titleWidth / 2, 15, 50, YELLOW);
             
             // CARD 1: CONTROLS
@@ -1384,121 +1434,121 @@ int main(void) {
             int cardWidth = 340;
             int cardHeight = 200;
             
-            DrawRectangle(cardX, cardY, cardWidth, cardHeight, Fade((Color){40, 40, 60, 255}, 0.7f));
-            DrawRectangleLines(cardX, cardY, cardWidth, cardHeight, SKYBLUE);
+            DrawRectangleCounted(cardX, cardY, cardWidth, cardHeight, Fade((Color){40, 40, 60, 255}, 0.7f));
+            DrawRectangleLinesCounted(cardX, cardY, cardWidth, cardHeight, SKYBLUE);
             
             // Centered card title
             const char* controlsTitle = "CONTROLS";
-            int controlsTitleWidth = MeasureText(controlsTitle, 22);
+            int controlsTitleWidth = MeasureTextCached(controlsTitle, 22);
             DrawTextWithShadow(controlsTitle, cardX + (cardWidth - controlsTitleWidth) / 2, cardY + 10, 22, ORANGE);
-            DrawLine(cardX + 15, cardY + 40, cardX + cardWidth - 15, cardY + 40, SKYBLUE);
+            DrawLineCounted(cardX + 15, cardY + 40, cardX + cardWidth - 15, cardY + 40, SKYBLUE);
             
-            DrawText("↔ LEFT/RIGHT ARROW", cardX + 20, cardY + 55, 16, WHITE);
-            DrawText("Move Paddle", cardX + 50, cardY + 75, 14, LIGHTGRAY);
+            DrawTextCounted("↔ LEFT/RIGHT ARROW", cardX + 20, cardY + 55, 16, WHITE);
+            DrawTextCounted("Move Paddle", cardX + 50, cardY + 75, 14, LIGHTGRAY);
             
-            DrawText("P or ESC", cardX + 20, cardY + 100, 16, WHITE);
-            DrawText("Pause Game", cardX + 50, cardY + 120, 14, LIGHTGRAY);
+            DrawTextCounted("P or ESC", cardX + 20, cardY + 100, 16, WHITE);
+            DrawTextCounted("Pause Game", cardX + 50, cardY + 120, 14, LIGHTGRAY);
             
-            DrawText("SPACE", cardX + 20, cardY + 145, 16, WHITE);
-            DrawText("Continue / Confirm", cardX + 50, cardY + 165, 14, LIGHTGRAY);
+            DrawTextCounted("SPACE", cardX + 20, cardY + 145, 16, WHITE);
+            DrawTextCounted("Continue / Confirm", cardX + 50, cardY + 165, 14, LIGHTGRAY);
             
             // CARD 2: POWER-UPS
             cardX = 380;
             cardY = 80;
             
-            DrawRectangle(cardX, cardY, cardWidth, cardHeight, Fade((Color){40, 40, 60, 255}, 0.7f));
-            DrawRectangleLines(cardX, cardY, cardWidth, cardHeight, MAGENTA);
+            DrawRectangleCounted(cardX, cardY, cardWidth, cardHeight, Fade((Color){40, 40, 60, 255}, 0.7f));
+            DrawRectangleLinesCounted(cardX, cardY, cardWidth, cardHeight, MAGENTA);
             
             // Centered card title
             const char* powerupsTitle = "POWER-UPS";
-            int powerupsTitleWidth = MeasureText(powerupsTitle, 22);
+            int powerupsTitleWidth = MeasureTextCached(powerupsTitle, 22);
             DrawTextWithShadow(powerupsTitle, cardX + (cardWidth - powerupsTitleWidth) / 2, cardY + 10, 22, ORANGE);
-            DrawLine(cardX + 15, cardY + 40, cardX + cardWidth - 15, cardY + 40, MAGENTA);
+            DrawLineCounted(cardX + 15, cardY + 40, cardX + cardWidth - 15, cardY + 40, MAGENTA);
             
             // Multiball
-            DrawRectangle(cardX + 15, cardY + 55, 16, 16, SKYBLUE);
-            DrawText("Multiball - Extra Ball", cardX + 40, cardY + 55, 14, WHITE);
+            DrawRectangleCounted(cardX + 15, cardY + 55, 16, 16, SKYBLUE);
+            DrawTextCounted("Multiball - Extra Ball", cardX + 40, cardY + 55, 14, WHITE);
             
             // Wide Paddle
-            DrawRectangle(cardX + 15, cardY + 80, 16, 16, LIME);
-            DrawText("Wide Paddle - 10s", cardX + 40, cardY + 80, 14, WHITE);
+            DrawRectangleCounted(cardX + 15, cardY + 80, 16, 16, LIME);
+            DrawTextCounted("Wide Paddle - 10s", cardX + 40, cardY + 80, 14, WHITE);
             
             // Screen Wide
-            DrawRectangle(cardX + 15, cardY + 105, 16, 16, MAGENTA);
-            DrawText("Screen Wide - 5s", cardX + 40, cardY + 105, 14, WHITE);
+            DrawRectangleCounted(cardX + 15, cardY + 105, 16, 16, MAGENTA);
+            DrawTextCounted("Screen Wide - 5s", cardX + 40, cardY + 105, 14, WHITE);
             
             // Extra Life
-            DrawRectangle(cardX + 15, cardY + 130, 16, 16, RED);
-            DrawText("Extra Life - +1 Life", cardX + 40, cardY + 130, 14, WHITE);
+            DrawRectangleCounted(cardX + 15, cardY + 130, 16, 16, RED);
+            DrawTextCounted("Extra Life - +1 Life", cardX + 40, cardY + 130, 14, WHITE);
             
             // Centered spawn rate text
             const char* spawnText = "20% spawn rate";
-            int spawnTextWidth = MeasureText(spawnText, 12);
-            DrawText(spawnText, cardX + (cardWidth - spawnTextWidth) / 2, cardY + 165, 12, SKYBLUE);
+            int spawnTextWidth = MeasureTextCached(spawnText, 12);
+            DrawTextCounted(spawnText, cardX + (cardWidth - spawnTextWidth) / 2, cardY + 165, 12, SKYBLUE);
             
             // CARD 3: BRICK TYPES (Row 2)
             cardX = 20;
             cardY = 300;
             
-            DrawRectangle(cardX, cardY, cardWidth, 220, Fade((Color){40, 40, 60, 255}, 0.7f));
-            DrawRectangleLines(cardX, cardY, cardWidth, 220, GREEN);
+            DrawRectangleCounted(cardX, cardY, cardWidth, 220, Fade((Color){40, 40, 60, 255}, 0.7f));
+            DrawRectangleLinesCounted(cardX, cardY, cardWidth, 220, GREEN);
             
             // Centered card title
             const char* bricksTitle = "BRICK TYPES";
-            int bricksTitleWidth = MeasureText(bricksTitle, 22);
+            int bricksTitleWidth = MeasureTextCached(bricksTitle, 22);
             DrawTextWithShadow(bricksTitle, cardX + (cardWidth - bricksTitleWidth) / 2, cardY + 10, 22, ORANGE);
-            DrawLine(cardX + 15, cardY + 40, cardX + cardWidth - 15, cardY + 40, GREEN);
+            DrawLineCounted(cardX + 15, cardY + 40, cardX + cardWidth - 15, cardY + 40, GREEN);
             
             // Normal Brick
-            DrawRectangle(cardX + 15, cardY + 55, 16, 12, RED);
-            DrawText("Normal - 1 hit, 10 pts", cardX + 40, cardY + 54, 13, WHITE);
+            DrawRectangleCounted(cardX + 15, cardY + 55, 16, 12, RED);
+            DrawTextCounted("Normal - 1 hit, 10 pts", cardX + 40, cardY + 54, 13, WHITE);
             
             // Tough Brick
-            DrawRectangle(cardX + 15, cardY + 80, 16, 12, (Color){80, 0, 0, 255});
-            DrawText("Tough - 2-3 hits, 30 pts", cardX + 40, cardY + 79, 13, WHITE);
+            DrawRectangleCounted(cardX + 15, cardY + 80, 16, 12, (Color){80, 0, 0, 255});
+            DrawTextCounted("Tough - 2-3 hits, 30 pts", cardX + 40, cardY + 79, 13, WHITE);
             
             // Explosive
-            DrawRectangle(cardX + 15, cardY + 105, 16, 12, PURPLE);
-            DrawText("Explosive - AOE, 50 pts", cardX + 40, cardY + 104, 13, WHITE);
+            DrawRectangleCounted(cardX + 15, cardY + 105, 16, 12, PURPLE);
+            DrawTextCounted("Explosive - AOE, 50 pts", cardX + 40, cardY + 104, 13, WHITE);
             
             // Speed
-            DrawRectangle(cardX + 15, cardY + 130, 16, 12, LIME);
-            DrawText("Speed - Ball +20%", cardX + 40, cardY + 129, 13, WHITE);
+            DrawRectangleCounted(cardX + 15, cardY + 130, 16, 12, LIME);
+            DrawTextCounted("Speed - Ball +20%", cardX + 40, cardY + 129, 13, WHITE);
             
             // Invisible
-            DrawRectangle(cardX + 15, cardY + 155, 16, 12, GRAY);
-            DrawRectangleLines(cardX + 15, cardY + 155, 16, 12, WHITE);
-            DrawText("Invisible - Hidden, 15 pts", cardX + 40, cardY + 154, 13, WHITE);
+            DrawRectangleCounted(cardX + 15, cardY + 155, 16, 12, GRAY);
+            DrawRectangleLinesCounted(cardX + 15, cardY + 155, 16, 12, WHITE);
+            DrawTextCounted("Invisible - Hidden, 15 pts", cardX + 40, cardY + 154, 13, WHITE);
             
             // CARD 4: SCORING BONUSES
             cardX = 380;
             cardY = 300;
             
-            DrawRectangle(cardX, cardY, cardWidth, 220, Fade((Color){40, 40, 60, 255}, 0.7f));
-            DrawRectangleLines(cardX, cardY, cardWidth, 220, ORANGE);
+            DrawRectangleCounted(cardX, cardY, cardWidth, 220, Fade((Color){40, 40, 60, 255}, 0.7f));
+            DrawRectangleLinesCounted(cardX, cardY, cardWidth, 220, ORANGE);
             
             // Centered card title
             const char* scoringTitle = "SCORING";
-            int scoringTitleWidth = MeasureText(scoringTitle, 22);
+            int scoringTitleWidth = MeasureTextCached(scoringTitle, 22);
             DrawTextWithShadow(scoringTitle, cardX + (cardWidth - scoringTitleWidth) / 2, cardY + 10, 22, ORANGE);
-            DrawLine(cardX + 15, cardY + 40, cardX + cardWidth - 15, cardY + 40, ORANGE);
+            DrawLineCounted(cardX + 15, cardY + 40, cardX + cardWidth - 15, cardY + 40, ORANGE);
             
             // Centered COMBO SYSTEM label
             const char* comboLabel = "COMBO SYSTEM";
-            int comboLabelWidth = MeasureText(comboLabel, 16);
-            DrawText(comboLabel, cardX + (cardWidth - comboLabelWidth) / 2, cardY + 55, 16, YELLOW);
+            int comboLabelWidth = MeasureTextCached(comboLabel, 16);
+            DrawTextCounted(comboLabel, cardX + (cardWidth - comboLabelWidth) / 2, cardY + 55, 16, YELLOW);
             
-            DrawText("Hit bricks without", cardX + 25, cardY + 80, 12, WHITE);
-            DrawText("touching paddle", cardX + 25, cardY + 97, 12, WHITE);
-            DrawText("Multiplier: 1.0x → 3.0x", cardX + 25, cardY + 114, 12, ORANGE);
+            DrawTextCounted("Hit bricks without", cardX + 25, cardY + 80, 12, WHITE);
+            DrawTextCounted("touching paddle", cardX + 25, cardY + 97, 12, WHITE);
+            DrawTextCounted("Multiplier: 1.0x → 3.0x", cardX + 25, cardY + 114, 12, ORANGE);
             
             // Centered TIME BONUS label
             const char* bonusLabel = "TIME BONUS";
-            int bonusLabelWidth = MeasureText(bonusLabel, 16);
-            DrawText(bonusLabel, cardX + (cardWidth - bonusLabelWidth) / 2, cardY + 145, 16, YELLOW);
+            int bonusLabelWidth = MeasureTextCached(bonusLabel, 16);
+            DrawTextCounted(bonusLabel, cardX + (cardWidth - bonusLabelWidth) / 2, cardY + 145, 16, YELLOW);
             
-            DrawText("Complete < 60s", cardX + 25, cardY + 170, 12, WHITE);
-            DrawText("Up to 500 pts", cardX + 25, cardY + 187, 12, ORANGE);
+            DrawTextCounted("Complete < 60s", cardX + 25, cardY + 170, 12, WHITE);
+            DrawTextCounted("Up to 500 pts", cardX + 25, cardY + 187, 12, ORANGE);
             
             // Back button centered
             Rectangle backButton = { screenWidth / 2 - 100, 540, 200, 50 };
@@ -1508,75 +1558,143 @@ int main(void) {
         }
         else if (gameState == PAUSED) {
             // Draw semi-transparent overlay
-            DrawRectangle(0, 0, screenWidth, screenHeight, Fade(BLACK, 0.5f));
+            DrawRectangleCounted(0, 0, screenWidth, screenHeight, Fade(BLACK, 0.5f));
             
             // Draw pause menu
             DrawTextWithShadow("PAUSED", screenWidth / 2 - 120, 150, 60, YELLOW);
-            DrawText("Press P or ESC to Resume", screenWidth / 2 - 180, 250, 25, LIGHTGRAY);
-            DrawText("Press Q to Quit to Menu", screenWidth / 2 - 170, 300, 25, LIGHTGRAY);
+            DrawTextCounted("Press P or ESC to Resume", screenWidth / 2 - 180, 250, 25, LIGHTGRAY);
+            DrawTextCounted("Press Q to Quit to Menu", screenWidth / 2 - 170, 300, 25, LIGHTGRAY);
+            DrawTextCounted("Press R to Restart Level", screenWidth / 2 - 170, 340, 25, LIGHTGRAY);
             
             // Show current stats
-            char pauseStats[100];
-            sprintf_s(pauseStats, sizeof(pauseStats), "Level: %d | Score: %d | Time: %.1fs", currentLevel, score, levelTimer);
-            int statsWidth = MeasureText(pauseStats, 20);
-            DrawTextWithShadow(pauseStats, screenWidth / 2 - statsWidth / 2, 380, 20, SKYBLUE);
+            // Keyed on all three values: level (16 bits), time in tenths (16 bits), score (32 bits)
+            static CachedText pauseStats;
+            int pauseTenths = (int)(sim.levelTimer * 10.0f + 0.5f);
+            int64_t pauseKey = ((int64_t)(sim.level & 0xFFFF) << 48) | ((int64_t)(pauseTenths & 0xFFFF) << 32) | (uint32_t)sim.score;
+            FormatCachedText(&pauseStats, pauseKey, 20, "Level: %d | Score: %d | Time: %d.%ds", sim.level, sim.score,
+                             pauseTenths / 10, pauseTenths % 10);
+            DrawTextWithShadow(pauseStats.text, screenWidth / 2 - pauseStats.width / 2, 380, 20, SKYBLUE);
         }
         else if (gameState == LEVEL_SUMMARY) {
             // Draw level summary screen
-            DrawRectangle(0, 0, screenWidth, screenHeight, Fade(BLACK, 0.3f));
+            DrawRectangleCounted(0, 0, screenWidth, screenHeight, Fade(BLACK, 0.3f));
             
             // Draw background box
-            DrawRectangle(screenWidth / 2 - 200, 100, 400, 400, Fade(DARKBLUE, 0.8f));
-            DrawRectangleLines(screenWidth / 2 - 200, 100, 400, 400, SKYBLUE);
+            DrawRectangleCounted(screenWidth / 2 - 200, 100, 400, 400, Fade(DARKBLUE, 0.8f));
+            DrawRectangleLinesCounted(screenWidth / 2 - 200, 100, 400, 400, SKYBLUE);
             
             // Draw title
             DrawTextWithShadow("LEVEL COMPLETE!", screenWidth / 2 - 160, 130, 50, GOLD);
             
             // Draw stats
-            char bricksText[50];
-            sprintf_s(bricksText, sizeof(bricksText), "Bricks Smashed: %d", bricksSmashed);
-            DrawTextWithShadow(bricksText, screenWidth / 2 - 140, 220, 25, LIME);
-            
-            char timeText[50];
-            sprintf_s(timeText, sizeof(timeText), "Time Taken: %.1f seconds", levelCompletionTime);
-            DrawTextWithShadow(timeText, screenWidth / 2 - 140, 270, 25, SKYBLUE);
-            
-            // Calculate and display time bonus
-            int timeBonus = 0;
-            if (levelCompletionTime < TIME_LIMIT) {
-                timeBonus = (int)(MAX_TIME_BONUS * (1.0f - levelCompletionTime / TIME_LIMIT));
-                score += timeBonus;
-            }
+            static CachedText bricksText;
+            FormatCachedText(&bricksText, sim.bricksSmashed, 25, "Bricks Smashed: %d", sim.bricksSmashed);
+            DrawTextWithShadow(bricksText.text, screenWidth / 2 - 140, 220, 25, LIME);
+            
+            static CachedText timeText;
+            int completionTenths = (int)(sim.levelCompletionTime * 10.0f + 0.5f);
+            FormatCachedText(&timeText, completionTenths, 25, "Time Taken: %d.%d seconds", completionTenths / 10,
+                             completionTenths % 10);
+            DrawTextWithShadow(timeText.text, screenWidth / 2 - 140, 270, 25, SKYBLUE);
             
-            char bonusText[60];
-            sprintf_s(bonusText, sizeof(bonusText), "Time Bonus: +%d pts", timeBonus);
-            DrawTextWithShadow(bonusText, screenWidth / 2 - 140, 320, 25, ORANGE);
+            // Time bonus (awarded once by the simulation when the level was cleared)
+            static CachedText bonusText;
+            FormatCachedText(&bonusText, sim.timeBonus, 25, "Time Bonus: +%d pts", sim.timeBonus);
+            DrawTextWithShadow(bonusText.text, screenWidth / 2 - 140, 320, 25, ORANGE);
             
-            char totalText[50];
-            sprintf_s(totalText, sizeof(totalText), "Total Score: %d", score);
-            DrawTextWithShadow(totalText, screenWidth / 2 - 140, 370, 25, YELLOW);
+            static CachedText totalText;
+            FormatCachedText(&totalText, sim.score, 25, "Total Score: %d", sim.score);
+            DrawTextWithShadow(totalText.text, screenWidth / 2 - 140, 370, 25, YELLOW);
             
             // Auto-advance or press space to continue
             if (levelSummaryTimer <= 0.0f) {
-                DrawText("Press SPACE to continue", screenWidth / 2 - 150, 450, 20, LIGHTGRAY);
+                DrawTextCounted("Press SPACE to continue", screenWidth / 2 - 150, 450, 20, LIGHTGRAY);
             } else {
-                char autoAdvanceText[50];
-                sprintf_s(autoAdvanceText, sizeof(autoAdvanceText), "Next level in %.1f...", levelSummaryTimer);
-                DrawText(autoAdvanceText, screenWidth / 2 - 120, 450, 20, LIME);
+                static CachedText autoAdvanceText;
+                int advanceTenths = (int)(levelSummaryTimer * 10.0f + 0.5f);
+                FormatCachedText(&autoAdvanceText, advanceTenths, 20, "Next level in %d.%d...", advanceTenths / 10,
+                                 advanceTenths % 10);
+                DrawTextCounted(autoAdvanceText.text, screenWidth / 2 - 120, 450, 20, LIME);
             }
         }
 
-        EndDrawing();
+        if (frameStats.visible) DrawFrameStats(screenHeight);
+
+        EndCanvasFrame(&canvas);
+
+        // Publish last second's averages (the frame's draws, presentation included)
+        frameStats.frames++;
+        frameStats.drawCalls += renderDrawCalls;
+        double statsWindow = GetTime() - frameStats.windowStart;
+        if (statsWindow >= 1.0) {
+            frameStats.drawCallsPerFrame = (float)frameStats.hudDrawCalls / frameStats.frames;
+            frameStats.redrawsPerSecond = (float)(frameStats.hudRedraws / statsWindow);
+            frameStats.microsPerFrame = (float)(frameStats.hudSeconds / frameStats.frames * 1e6);
+            frameStats.brickRedrawsPerSecond = (float)(frameStats.brickRedraws / statsWindow);
+            frameStats.frameDrawCallsPerFrame = (float)frameStats.drawCalls / frameStats.frames;
+            if (frameStats.snapshots > 0) frameStats.microsPerSnapshot = (float)(frameStats.snapshotSeconds / frameStats.snapshots * 1e6);
+            frameStats.frames = 0;
+            frameStats.drawCalls = 0;
+            frameStats.hudDrawCalls = 0;
+            frameStats.hudRedraws = 0;
+            frameStats.hudSeconds = 0.0;
+            frameStats.brickRedraws = 0;
+            frameStats.snapshots = 0;
+            frameStats.snapshotSeconds = 0.0;
+            frameStats.windowStart = GetTime();
+        }
+
+        // Render test: capture and check the last frame of each step
+        if (renderTest) {
+            renderTestSeconds += GetTime() - renderStart;
+            renderTestDrawCalls += renderDrawCalls;
+            const RenderTestStep *step = &renderTestSteps[renderTestStep];
+            if (++renderTestFrame == step->frames) {
+                Image frame = LoadImageFromTexture(canvas.target.texture);
+                ImageFlipVertical(&frame);  // Render textures are stored bottom-up
+                int mismatched = CompareRenderTestFrame(frame, renderTestDir, step->name);
+                int allowed = (int)(frame.width * frame.height * RENDER_TEST_MAX_MISMATCH);
+                UnloadImage(frame);
+
+                char result[64];
+                if (mismatched < 0) {
+                    sprintf_s(result, sizeof(result), "FAILED to read or write the image");
+                } else if (mismatched > allowed) {
+                    sprintf_s(result, sizeof(result), "MISMATCH: %d pixels differ", mismatched);
+                } else {
+                    sprintf_s(result, sizeof(result), "ok (%d pixels differ)", mismatched);
+                }
+                printf("%-14s %4d frames %8.1f draw calls/frame %8.3f ms/frame  %s\n", step->name, step->frames,
+                       (double)renderTestDrawCalls / step->frames, renderTestSeconds / step->frames * 1e3, result);
+                if (mismatched < 0 || mismatched > allowed) exitCode = 2;
+
+                renderTestFrame = 0;
+                renderTestDrawCalls = 0;
+                renderTestSeconds = 0.0;
+                renderTestDone = ++renderTestStep == RENDER_TEST_STEPS;
+            }
+        }
     }
+    if (renderTest) printf("%s\n", (exitCode == 0) ? "Render test passed" : "Render test FAILED");
 
     // 3. De-initialization
-    UnloadSound(loseHeartSound);
-    UnloadSound(gameOverSound);
-    UnloadSound(paddleHitSound);
-    UnloadSound(wallHitSound);
-    UnloadSound(brickHitSound);
+    SaveGameReplay();  // Window closed mid-game
+    FreeReplay(&gameReplay);
+    FreeSnapshotRing(&rewindRing);
+    FreeSimSnapshot(&levelStart);
+    UnloadHudIcons();
+    if (IsRenderTextureReady(hudLayer)) UnloadRenderTexture(hudLayer);
+    UnloadBrickLayer(&brickLayer);
+    FreeBallTrails(&ballTrails);
+    FreeSimMotion(&simMotion);
+    UnloadCanvas(&canvas);
+    UnloadSoundMixer(&soundMixer);
     UnloadMusicStream(menuMusic);
+    FreeSimState(&sim);
+    FreeSimEventList(&simEvents);
+    FreeParticleField(&brickParticles);
+    FreeParticleField(&deathParticles);
     CloseAudioDevice();
     CloseWindow();
-    return 0;
+    return exitCode;
 }
\ No newline at end of file
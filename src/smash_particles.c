@@ -0,0 +1,243 @@
+#include <stdlib.h>
+#include <string.h>
+#include "smash_particles.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define PARTICLES_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+typedef void (*ParticleKernel)(ParticleField *field, int count, float deltaTime);
+
+// Reference kernel. A particle whose lifetime runs out this tick is clamped to 0 and
+// left where it is; the compaction pass that follows drops it.
+static void UpdateParticlesScalar(ParticleField *field, int count, float deltaTime) {
+    float gravityStep = field->gravity * deltaTime;
+    float alphaScale = field->maxAlpha / field->maxLifetime;
+    for (int i = 0; i < count; i++) {
+        float lifetime = field->lifetime[i] - deltaTime;
+        if (lifetime > 0.0f) {
+            field->posX[i] += field->velX[i] * deltaTime;
+            field->posY[i] += field->velY[i] * deltaTime;
+            field->velY[i] += gravityStep;
+        } else {
+            lifetime = 0.0f;
+        }
+        float alpha = lifetime * alphaScale;
+        field->lifetime[i] = lifetime;
+        field->alpha[i] = (alpha < field->maxAlpha) ? alpha : field->maxAlpha;
+    }
+}
+
+#ifdef PARTICLES_X86_SIMD
+// Same maths as the scalar kernel, 4 lanes at a time; the alive test becomes a mask
+// ANDed into the position and velocity steps instead of a branch
+__attribute__((target("sse2")))
+static void UpdateParticlesSSE2(ParticleField *field, int count, float deltaTime) {
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 gravityStep = _mm_set1_ps(field->gravity * deltaTime);
+    const __m128 alphaScale = _mm_set1_ps(field->maxAlpha / field->maxLifetime);
+    const __m128 maxAlpha = _mm_set1_ps(field->maxAlpha);
+    const __m128 zero = _mm_setzero_ps();
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 lifetime = _mm_sub_ps(_mm_loadu_ps(field->lifetime + i), dt);
+        __m128 alive = _mm_cmpgt_ps(lifetime, zero);
+        __m128 velX = _mm_loadu_ps(field->velX + i);
+        __m128 velY = _mm_loadu_ps(field->velY + i);
+
+        __m128 posX = _mm_add_ps(_mm_loadu_ps(field->posX + i), _mm_and_ps(alive, _mm_mul_ps(velX, dt)));
+        __m128 posY = _mm_add_ps(_mm_loadu_ps(field->posY + i), _mm_and_ps(alive, _mm_mul_ps(velY, dt)));
+        velY = _mm_add_ps(velY, _mm_and_ps(alive, gravityStep));
+        lifetime = _mm_max_ps(lifetime, zero);
+
+        _mm_storeu_ps(field->posX + i, posX);
+        _mm_storeu_ps(field->posY + i, posY);
+        _mm_storeu_ps(field->velY + i, velY);
+        _mm_storeu_ps(field->lifetime + i, lifetime);
+        _mm_storeu_ps(field->alpha + i, _mm_min_ps(_mm_mul_ps(lifetime, alphaScale), maxAlpha));
+    }
+    if (i < count) {
+        ParticleField tail = *field;
+        tail.posX += i; tail.posY += i; tail.velX += i; tail.velY += i;
+        tail.lifetime += i; tail.alpha += i;
+        UpdateParticlesScalar(&tail, count - i, deltaTime);
+    }
+}
+
+__attribute__((target("avx2")))
+static void UpdateParticlesAVX2(ParticleField *field, int count, float deltaTime) {
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 gravityStep = _mm256_set1_ps(field->gravity * deltaTime);
+    const __m256 alphaScale = _mm256_set1_ps(field->maxAlpha / field->maxLifetime);
+    const __m256 maxAlpha = _mm256_set1_ps(field->maxAlpha);
+    const __m256 zero = _mm256_setzero_ps();
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 lifetime = _mm256_sub_ps(_mm256_loadu_ps(field->lifetime + i), dt);
+        __m256 alive = _mm256_cmp_ps(lifetime, zero, _CMP_GT_OQ);
+        __m256 velX = _mm256_loadu_ps(field->velX + i);
+        __m256 velY = _mm256_loadu_ps(field->velY + i);
+
+        __m256 posX = _mm256_add_ps(_mm256_loadu_ps(field->posX + i), _mm256_and_ps(alive, _mm256_mul_ps(velX, dt)));
+        __m256 posY = _mm256_add_ps(_mm256_loadu_ps(field->posY + i), _mm256_and_ps(alive, _mm256_mul_ps(velY, dt)));
+        velY = _mm256_add_ps(velY, _mm256_and_ps(alive, gravityStep));
+        lifetime = _mm256_max_ps(lifetime, zero);
+
+        _mm256_storeu_ps(field->posX + i, posX);
+        _mm256_storeu_ps(field->posY + i, posY);
+        _mm256_storeu_ps(field->velY + i, velY);
+        _mm256_storeu_ps(field->lifetime + i, lifetime);
+        _mm256_storeu_ps(field->alpha + i, _mm256_min_ps(_mm256_mul_ps(lifetime, alphaScale), maxAlpha));
+    }
+    if (i < count) {
+        ParticleField tail = *field;
+        tail.posX += i; tail.posY += i; tail.velX += i; tail.velY += i;
+        tail.lifetime += i; tail.alpha += i;
+        UpdateParticlesScalar(&tail, count - i, deltaTime);
+    }
+}
+#endif
+
+static ParticleKernel particleKernel = NULL;
+static const char *particleKernelName = "scalar";
+
+// Pick the widest kernel this CPU runs, once
+static void SelectParticleKernel(void) {
+    if (particleKernel != NULL) return;
+    particleKernel = UpdateParticlesScalar;
+#ifdef PARTICLES_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        particleKernel = UpdateParticlesAVX2;
+        particleKernelName = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        particleKernel = UpdateParticlesSSE2;
+        particleKernelName = "sse2";
+    }
+#endif
+}
+
+void InitEmitterPool(EmitterPool *pool, int capacity, PoolSaturation saturation) {
+    pool->count = 0;
+    pool->capacity = capacity;
+    pool->evictCursor = 0;
+    pool->dropped = 0;
+    pool->saturation = saturation;
+}
+
+// O(1): the first free slot is always pool->count. When full, POOL_DROP_OLDEST walks
+// the evict cursor through the (age ordered) live range, wrapping at the end.
+int AcquirePoolSlot(EmitterPool *pool) {
+    if (pool->count < pool->capacity) return pool->count++;
+
+    pool->dropped++;
+    if (pool->saturation == POOL_DROP_NEW || pool->capacity == 0) return -1;
+    int slot = pool->evictCursor;
+    pool->evictCursor = (pool->evictCursor + 1) % pool->capacity;
+    return slot;
+}
+
+void SetPoolCount(EmitterPool *pool, int count) {
+    pool->count = count;
+    pool->evictCursor = 0;
+}
+
+// Allocate all lanes in one block
+bool InitParticleField(ParticleField *field, int capacity, PoolSaturation saturation,
+                       float maxLifetime, float gravity, float maxAlpha) {
+    memset(field, 0, sizeof(*field));
+    if (capacity < 1) capacity = 1;
+    float *block = calloc((size_t)capacity * 6, sizeof(float));
+    if (block == NULL) return false;
+
+    field->posX = block;
+    field->posY = block + capacity;
+    field->velX = block + capacity * 2;
+    field->velY = block + capacity * 3;
+    field->lifetime = block + capacity * 4;
+    field->alpha = block + capacity * 5;
+    InitEmitterPool(&field->pool, capacity, saturation);
+    field->maxLifetime = maxLifetime;
+    field->gravity = gravity;
+    field->maxAlpha = maxAlpha;
+
+    SelectParticleKernel();
+    return true;
+}
+
+void FreeParticleField(ParticleField *field) {
+    free(field->posX);
+    memset(field, 0, sizeof(*field));
+}
+
+// Drop every live particle
+void ClearParticleField(ParticleField *field) {
+    SetPoolCount(&field->pool, 0);
+}
+
+bool SpawnParticle(ParticleField *field, float x, float y, float velX, float velY) {
+    int i = AcquirePoolSlot(&field->pool);
+    if (i < 0) return false;
+    field->posX[i] = x;
+    field->posY[i] = y;
+    field->velX[i] = velX;
+    field->velY[i] = velY;
+    field->lifetime[i] = field->maxLifetime;
+    field->alpha[i] = field->maxAlpha;
+    return true;
+}
+
+static void ReverseLane(float *lane, int start, int end) {
+    for (end--; start < end; start++, end--) {
+        float swap = lane[start];
+        lane[start] = lane[end];
+        lane[end] = swap;
+    }
+}
+
+// Move the first shift elements behind the rest, by three reversals
+static void RotateLane(float *lane, int count, int shift) {
+    ReverseLane(lane, 0, shift);
+    ReverseLane(lane, shift, count);
+    ReverseLane(lane, 0, count);
+}
+
+// Move survivors to the front, keeping their order. Every particle is copied and the
+// write index only advances for live ones, so the loop has no data-dependent branch.
+// Survivors of recycled slots then go behind the older ones.
+static int CompactParticles(ParticleField *field, int count) {
+    int recycled = field->pool.evictCursor;
+    int newest = 0;
+    int live = 0;
+    for (int i = 0; i < count; i++) {
+        field->posX[live] = field->posX[i];
+        field->posY[live] = field->posY[i];
+        field->velX[live] = field->velX[i];
+        field->velY[live] = field->velY[i];
+        field->lifetime[live] = field->lifetime[i];
+        field->alpha[live] = field->alpha[i];
+        int alive = field->lifetime[i] > 0.0f;
+        newest += alive & (i < recycled);
+        live += alive;
+    }
+    if (newest > 0 && newest < live) {
+        float *lanes[] = { field->posX, field->posY, field->velX, field->velY, field->lifetime, field->alpha };
+        for (int l = 0; l < 6; l++) RotateLane(lanes[l], live, newest);
+    }
+    return live;
+}
+
+void UpdateParticleField(ParticleField *field, float deltaTime) {
+    int count = field->pool.count;
+    if (count == 0) return;
+    particleKernel(field, count, deltaTime);
+    SetPoolCount(&field->pool, CompactParticles(field, count));
+}
+
+const char *GetParticleKernelName(void) {
+    SelectParticleKernel();
+    return particleKernelName;
+}
@@ -0,0 +1,55 @@
+// Smash Out! particle kernel: SoA particle fields with AVX2/SSE2/scalar update
+// kernels picked at runtime. Pure C99 with no raylib dependency.
+
+#ifndef SMASH_PARTICLES_H
+#define SMASH_PARTICLES_H
+
+#include <stdbool.h>
+
+// What to do with a spawn when the pool is full
+typedef enum PoolSaturation {
+    POOL_DROP_NEW,     // Keep what is on screen, discard the new element
+    POOL_DROP_OLDEST   // Recycle the oldest live element for the new one
+} PoolSaturation;
+
+// Slot bookkeeping for a dense pool: live elements occupy [0, count) and every slot
+// past count is free, so the free list is just the end of the live range. Live slots
+// are kept oldest first: spawns append, and once full POOL_DROP_OLDEST recycles slots
+// from the front, so the oldest element is always the one at evictCursor. After each
+// update the owner compacts survivors to the front in order, rotates the ones before
+// evictCursor (recycled since the last compaction, so the newest) behind the rest,
+// and hands the new count back with SetPoolCount.
+typedef struct EmitterPool {
+    int count;
+    int capacity;
+    int evictCursor;  // Oldest live slot while recycling; 0 after compaction
+    int dropped;      // Spawns lost to saturation (stats)
+    PoolSaturation saturation;
+} EmitterPool;
+
+void InitEmitterPool(EmitterPool *pool, int capacity, PoolSaturation saturation);
+int AcquirePoolSlot(EmitterPool *pool);  // Slot for a new element, -1 when it is dropped
+void SetPoolCount(EmitterPool *pool, int count);
+
+typedef struct ParticleField {
+    float *posX;
+    float *posY;
+    float *velX;
+    float *velY;
+    float *lifetime;  // Seconds left
+    float *alpha;     // Fade alpha for drawing (0 - maxAlpha), written by the update
+    EmitterPool pool;   // Live particles are [0, pool.count)
+    float maxLifetime;  // Lifetime a particle spawns with; alpha fades over it
+    float gravity;      // Pixels per second squared
+    float maxAlpha;     // Alpha of a freshly spawned particle (0-255)
+} ParticleField;
+
+bool InitParticleField(ParticleField *field, int capacity, PoolSaturation saturation,
+                       float maxLifetime, float gravity, float maxAlpha);
+void FreeParticleField(ParticleField *field);
+void ClearParticleField(ParticleField *field);
+bool SpawnParticle(ParticleField *field, float x, float y, float velX, float velY);  // false when dropped (full, POOL_DROP_NEW)
+void UpdateParticleField(ParticleField *field, float deltaTime);  // Integrate, then compact the survivors
+const char *GetParticleKernelName(void);  // "avx2", "sse2" or "scalar"
+
+#endif // SMASH_PARTICLES_H
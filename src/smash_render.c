@@ -0,0 +1,705 @@
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "smash_render.h"
+#include <rlgl.h>
+
+#define BRICK_TYPE_COUNT 5
+#define BRICK_PALETTE_VARIANTS 5  // Row colors for NORMAL; the widest variant range
+
+#define GHOST_OUTLINE_COLOR (Color){ 100, 100, 100, 80 }
+#define BRICK_MIN_OUTLINED 3.0f  // Smaller bricks draw as one solid quad
+
+#define HUD_ICON_MAX_ROWS 8
+#define HUD_ICON_PADDING 1  // Blank texels between atlas entries, so scaled quads don't bleed
+
+// Pixel art, 'X' for a lit pixel
+typedef struct HudIconArt {
+    int width;
+    int height;
+    const char *rows[HUD_ICON_MAX_ROWS];
+} HudIconArt;
+
+static const HudIconArt hudIconArt[HUD_ICON_COUNT] = {
+    [HUD_ICON_HEART] = { 7, 6, {
+        " XX XX ",
+        "XXXXXXX",
+        "XXXXXXX",
+        " XXXXX ",
+        "  XXX  ",
+        "   X   "
+    } }
+};
+
+// Trail look: half-width (fraction of the ball radius) and alpha at the ball, tapering to 0
+#define TRAIL_HALF_WIDTH 0.6f
+#define TRAIL_ALPHA 75.0f
+
+// Text measurement cache: open addressing over a power-of-two table, probing a few
+// slots before evicting the home slot. Longer strings aren't cached.
+#define TEXT_MEASURE_SLOTS 256
+#define TEXT_MEASURE_PROBES 4
+#define TEXT_MEASURE_LENGTH 48
+
+typedef struct TextMeasure {
+    uint32_t hash;  // 0 for an empty slot
+    int fontSize;
+    int width;
+    char text[TEXT_MEASURE_LENGTH];
+} TextMeasure;
+
+static TextMeasure textMeasures[TEXT_MEASURE_SLOTS];
+
+static Texture2D hudIconAtlas;
+static Rectangle hudIconSource[HUD_ICON_COUNT];
+
+int renderDrawCalls = 0;
+
+void DrawRectangleCounted(int posX, int posY, int width, int height, Color color) {
+    DrawRectangle(posX, posY, width, height, color);
+    renderDrawCalls++;
+}
+
+void DrawRectangleRecCounted(Rectangle rec, Color color) {
+    DrawRectangleRec(rec, color);
+    renderDrawCalls++;
+}
+
+void DrawRectangleLinesCounted(int posX, int posY, int width, int height, Color color) {
+    DrawRectangleLines(posX, posY, width, height, color);
+    renderDrawCalls++;
+}
+
+void DrawLineCounted(int startPosX, int startPosY, int endPosX, int endPosY, Color color) {
+    DrawLine(startPosX, startPosY, endPosX, endPosY, color);
+    renderDrawCalls++;
+}
+
+void DrawCircleCounted(int centerX, int centerY, float radius, Color color) {
+    DrawCircle(centerX, centerY, radius, color);
+    renderDrawCalls++;
+}
+
+void DrawCircleVCounted(Vector2 center, float radius, Color color) {
+    DrawCircleV(center, radius, color);
+    renderDrawCalls++;
+}
+
+void DrawTextCounted(const char *text, int posX, int posY, int fontSize, Color color) {
+    DrawText(text, posX, posY, fontSize, color);
+    renderDrawCalls++;
+}
+
+void DrawTextureRecCounted(Texture2D texture, Rectangle source, Vector2 position, Color tint) {
+    DrawTextureRec(texture, source, position, tint);
+    renderDrawCalls++;
+}
+
+void DrawTextureProCounted(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) {
+    DrawTexturePro(texture, source, dest, origin, rotation, tint);
+    renderDrawCalls++;
+}
+
+// [type][variant]: row % 5 for NORMAL, health for TOUGH, discovered for INVISIBLE
+static Color brickPalette[BRICK_TYPE_COUNT][BRICK_PALETTE_VARIANTS];
+
+void InitBrickPalette(void) {
+    for (int type = 0; type < BRICK_TYPE_COUNT; type++) {
+        for (int variant = 0; variant < BRICK_PALETTE_VARIANTS; variant++) brickPalette[type][variant] = WHITE;
+    }
+
+    // Standard row-based coloring
+    brickPalette[BRICK_NORMAL][0] = RED;
+    brickPalette[BRICK_NORMAL][1] = ORANGE;
+    brickPalette[BRICK_NORMAL][2] = YELLOW;
+    brickPalette[BRICK_NORMAL][3] = GREEN;
+    brickPalette[BRICK_NORMAL][4] = BLUE;
+
+    // Tough bricks change color with health (3=dark red, 2=red, 1=pink)
+    for (int health = 0; health < BRICK_PALETTE_VARIANTS; health++) {
+        brickPalette[BRICK_TOUGH][health] = (Color){ 255, 100, 150, 255 };  // Pink
+    }
+    brickPalette[BRICK_TOUGH][2] = RED;
+    brickPalette[BRICK_TOUGH][3] = (Color){ 80, 0, 0, 255 };  // Dark Red
+
+    brickPalette[BRICK_EXPLOSIVE][0] = PURPLE;
+    brickPalette[BRICK_SPEED][0] = LIME;  // Lime for speed boosts
+    brickPalette[BRICK_INVISIBLE][0] = (Color){ 0, 0, 0, 0 };  // Invisible until hit
+    brickPalette[BRICK_INVISIBLE][1] = GRAY;
+}
+
+static Color LookUpBrickColor(const BrickField *field, int index, int row) {
+    int type = field->type[index];
+    if (type >= BRICK_TYPE_COUNT) return WHITE;
+
+    int variant = 0;
+    switch (type) {
+        case BRICK_NORMAL: variant = row % BRICK_PALETTE_VARIANTS; break;
+        case BRICK_TOUGH: variant = (field->health[index] < BRICK_PALETTE_VARIANTS) ? field->health[index] : 0; break;
+        case BRICK_INVISIBLE: variant = IsBrickDiscovered(field, index) ? 1 : 0; break;
+        default: break;
+    }
+    return brickPalette[type][variant];
+}
+
+Color GetBrickColor(const BrickField *field, int index) {
+    return LookUpBrickColor(field, index, index / field->layout.cols);
+}
+
+// Texture coordinates of the shapes texture's white rectangle
+typedef struct QuadCoords {
+    float u0, v0, u1, v1;
+} QuadCoords;
+
+static QuadCoords GetShapesCoords(void) {
+    Texture2D texture = GetShapesTexture();
+    Rectangle source = GetShapesTextureRectangle();
+    return (QuadCoords){ source.x / texture.width, source.y / texture.height,
+                         (source.x + source.width) / texture.width, (source.y + source.height) / texture.height };
+}
+
+// One quad, wound like raylib's own rectangles
+static void PushQuad(float x, float y, float width, float height, Color color, QuadCoords uv) {
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlTexCoord2f(uv.u0, uv.v0);
+    rlVertex2f(x, y);
+    rlTexCoord2f(uv.u0, uv.v1);
+    rlVertex2f(x, y + height);
+    rlTexCoord2f(uv.u1, uv.v1);
+    rlVertex2f(x + width, y + height);
+    rlTexCoord2f(uv.u1, uv.v0);
+    rlVertex2f(x + width, y);
+}
+
+// Quads for brick i at (x, y) in whole pixels; clearColor, when not NULL, first covers
+// the cell so a layer can redraw a brick in place. Bricks too small for an outline
+// are one solid quad and lose their ghost edges. Returns false if nothing was drawn.
+static bool PushBrick(const BrickField *field, int i, int row, float x, float y, QuadCoords uv, const Color *clearColor) {
+    const BoardLayout *layout = &field->layout;
+    float width = layout->brickWidth;
+    float height = layout->brickHeight;
+    bool solid = width < BRICK_MIN_OUTLINED || height < BRICK_MIN_OUTLINED;
+    Color ghost = GHOST_OUTLINE_COLOR;
+
+    // Flush first if the batch can't take the clear and four more quads
+    if (rlCheckRenderBatchLimit(20)) renderDrawCalls++;
+    if (clearColor != NULL) PushQuad(x, y, width, height, *clearColor, uv);
+
+    if (IsBrickActive(field, i)) {
+        Color color = LookUpBrickColor(field, i, row);
+        if (color.a == 0) return false;  // Undiscovered: its black outline would vanish into the background anyway
+        if (solid) {
+            PushQuad(x, y, width, height, color, uv);
+            return true;
+        }
+        PushQuad(x, y, width, height, BLACK, uv);
+        PushQuad(x + 1.0f, y + 1.0f, width - 2.0f, height - 2.0f, color, uv);
+        return true;
+    }
+    if (!solid && field->type[i] == BRICK_INVISIBLE && !IsBrickDiscovered(field, i)) {
+        // Undiscovered invisible bricks leave a faint outline
+        PushQuad(x, y, width, 1.0f, ghost, uv);
+        PushQuad(x, y + height - 1.0f, width, 1.0f, ghost, uv);
+        PushQuad(x, y + 1.0f, 1.0f, height - 2.0f, ghost, uv);
+        PushQuad(x + width - 1.0f, y + 1.0f, 1.0f, height - 2.0f, ghost, uv);
+        return true;
+    }
+    return false;
+}
+
+void DrawBrickField(const BrickField *field, Vector2 offset) {
+    const BoardLayout *layout = &field->layout;
+    QuadCoords uv = GetShapesCoords();
+
+    rlSetTexture(GetShapesTexture().id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (int row = 0; row < layout->rows; row++) {
+        // Outlines sit on whole pixels, as DrawRectangleLines put them
+        float y = (float)(int)(layout->top + row * layout->pitchY + offset.y);
+        for (int col = 0; col < layout->cols; col++) {
+            float x = (float)(int)(layout->left + col * layout->pitchX + offset.x);
+            PushBrick(field, row * layout->cols + col, row, x, y, uv, NULL);
+        }
+    }
+    rlEnd();
+    rlSetTexture(0);
+    renderDrawCalls++;
+}
+
+// Whole-pixel position of brick i inside the layer
+static Vector2 GetLayerBrickPosition(const BrickLayer *layer, int i) {
+    const BoardLayout *layout = &layer->layout;
+    int row = i / layout->cols;
+    int col = i % layout->cols;
+    return (Vector2){ (float)((int)(layout->left + col * layout->pitchX) - (int)layer->bounds.x),
+                      (float)((int)(layout->top + row * layout->pitchY) - (int)layer->bounds.y) };
+}
+
+// Size the texture and the copies of the field for field's layout
+static bool ResetBrickLayer(BrickLayer *layer, const BrickField *field, int scalePercent) {
+    const BoardLayout *layout = &field->layout;
+    int words = (field->count + 31) / 32;
+    if (field->count > layer->capacity) {
+        int capacityWords = (field->count + 31) / 32;
+        uint32_t *active = realloc(layer->active, capacityWords * sizeof(uint32_t));
+        if (active != NULL) layer->active = active;
+        uint32_t *discovered = realloc(layer->discovered, capacityWords * sizeof(uint32_t));
+        if (discovered != NULL) layer->discovered = discovered;
+        uint8_t *type = realloc(layer->type, field->count);
+        if (type != NULL) layer->type = type;
+        uint8_t *health = realloc(layer->health, field->count);
+        if (health != NULL) layer->health = health;
+        if (active == NULL || discovered == NULL || type == NULL || health == NULL) return false;
+        layer->capacity = field->count;
+    }
+
+    Rectangle bounds = { 0.0f, 0.0f, 0.0f, 0.0f };
+    if (layout->cols > 0 && layout->rows > 0) {
+        bounds.x = (float)(int)layout->left;
+        bounds.y = (float)(int)layout->top;
+        bounds.width = ceilf(layout->left + (layout->cols - 1) * layout->pitchX + layout->brickWidth) - bounds.x;
+        bounds.height = ceilf(layout->top + (layout->rows - 1) * layout->pitchY + layout->brickHeight) - bounds.y;
+    }
+    if (bounds.width != layer->bounds.width || bounds.height != layer->bounds.height ||
+        scalePercent != layer->scalePercent || !IsRenderTextureReady(layer->target)) {
+        if (IsRenderTextureReady(layer->target)) UnloadRenderTexture(layer->target);
+        layer->target = (RenderTexture2D){ 0 };
+        if (bounds.width > 0.0f && bounds.height > 0.0f) {
+            layer->target = LoadRenderTexture((int)bounds.width * scalePercent / 100, (int)bounds.height * scalePercent / 100);
+            if (!IsRenderTextureReady(layer->target)) return false;
+        }
+    }
+    layer->scalePercent = scalePercent;
+
+    layer->bounds = bounds;
+    layer->layout = *layout;
+    layer->count = field->count;
+    memcpy(layer->active, field->activeMask, words * sizeof(uint32_t));
+    memcpy(layer->discovered, field->discoveredMask, words * sizeof(uint32_t));
+    memcpy(layer->type, field->type, field->count);
+    memcpy(layer->health, field->health, field->count);
+    return true;
+}
+
+bool UpdateBrickLayer(BrickLayer *layer, const BrickField *field, int scalePercent) {
+    layer->redrawn = 0;
+    bool rebuild = !layer->valid || layer->count != field->count || layer->scalePercent != scalePercent ||
+                   memcmp(&layer->layout, &field->layout, sizeof(BoardLayout)) != 0;
+    if (rebuild) {
+        layer->valid = false;
+        if (!ResetBrickLayer(layer, field, scalePercent)) return false;
+        layer->valid = true;
+        if (!IsRenderTextureReady(layer->target)) return true;  // Empty board
+    }
+
+    // Bricks draw replacing what is under them (alpha included), so each cell can be
+    // cleared and redrawn in place and the texture holds straight, unblended colors
+    QuadCoords uv = GetShapesCoords();
+    Color clear = BLANK;
+    Camera2D camera = { .zoom = layer->scalePercent / 100.0f };
+    bool drawing = false;
+    if (rebuild) {
+        BeginTextureMode(layer->target);
+        ClearBackground(BLANK);
+        BeginMode2D(camera);
+        drawing = true;
+    }
+
+    int words = (field->count + 31) / 32;
+    for (int w = 0; w < words; w++) {
+        int first = w * 32;
+        int n = (field->count - first < 32) ? field->count - first : 32;
+        if (!rebuild && field->activeMask[w] == layer->active[w] && field->discoveredMask[w] == layer->discovered[w] &&
+            memcmp(field->type + first, layer->type + first, n) == 0 &&
+            memcmp(field->health + first, layer->health + first, n) == 0) continue;
+
+        for (int i = first; i < first + n; i++) {
+            uint32_t bit = 1u << (i & 31);
+            bool changed = rebuild || ((field->activeMask[w] ^ layer->active[w]) & bit) ||
+                           ((field->discoveredMask[w] ^ layer->discovered[w]) & bit) ||
+                           field->type[i] != layer->type[i] || field->health[i] != layer->health[i];
+            if (!changed) continue;
+
+            if (!drawing) {
+                BeginTextureMode(layer->target);
+                BeginMode2D(camera);
+                drawing = true;
+            }
+            if (layer->redrawn == 0) {
+                rlSetBlendFactors(RL_ONE, RL_ZERO, RL_FUNC_ADD);
+                BeginBlendMode(BLEND_CUSTOM);
+                rlSetTexture(GetShapesTexture().id);
+                rlBegin(RL_QUADS);
+                rlNormal3f(0.0f, 0.0f, 1.0f);
+            }
+            Vector2 position = GetLayerBrickPosition(layer, i);
+            PushBrick(field, i, i / field->layout.cols, position.x, position.y, uv, rebuild ? NULL : &clear);
+            layer->redrawn++;
+            layer->type[i] = field->type[i];
+            layer->health[i] = field->health[i];
+        }
+        layer->active[w] = field->activeMask[w];
+        layer->discovered[w] = field->discoveredMask[w];
+    }
+
+    if (layer->redrawn > 0) {
+        rlEnd();
+        rlSetTexture(0);
+        EndBlendMode();
+        renderDrawCalls++;
+    }
+    if (drawing) {
+        EndMode2D();
+        EndTextureMode();
+    }
+    return true;
+}
+
+void DrawBrickLayer(const BrickLayer *layer, Vector2 offset) {
+    if (!layer->valid || !IsRenderTextureReady(layer->target)) return;
+    // Render textures are stored bottom-up, so flip the source rectangle
+    Rectangle source = { 0.0f, 0.0f, (float)layer->target.texture.width, -(float)layer->target.texture.height };
+    Rectangle dest = { layer->bounds.x + offset.x, layer->bounds.y + offset.y,
+                       layer->target.texture.width * 100.0f / layer->scalePercent,
+                       layer->target.texture.height * 100.0f / layer->scalePercent };
+    DrawTextureProCounted(layer->target.texture, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+}
+
+void UnloadBrickLayer(BrickLayer *layer) {
+    if (IsRenderTextureReady(layer->target)) UnloadRenderTexture(layer->target);
+    free(layer->active);
+    free(layer->discovered);
+    free(layer->type);
+    free(layer->health);
+    *layer = (BrickLayer){ 0 };
+}
+
+bool InitBallTrails(BallTrails *trails, int capacity) {
+    trails->trails = calloc((size_t)capacity, sizeof(BallTrail));
+    trails->capacity = (trails->trails != NULL) ? capacity : 0;
+    trails->count = 0;
+    return trails->trails != NULL;
+}
+
+void FreeBallTrails(BallTrails *trails) {
+    free(trails->trails);
+    *trails = (BallTrails){ 0 };
+}
+
+void ClearBallTrails(BallTrails *trails) {
+    for (int b = 0; b < trails->count; b++) trails->trails[b].length = 0;
+    trails->count = 0;
+}
+
+void RecordBallTrails(BallTrails *trails, const SimState *sim) {
+    int count = (sim->ballCount < trails->capacity) ? sim->ballCount : trails->capacity;
+    for (int b = count; b < trails->count; b++) trails->trails[b].length = 0;  // Balls lost
+    trails->count = count;
+
+    for (int b = 0; b < count; b++) {
+        BallTrail *trail = &trails->trails[b];
+        const Ball *ball = &sim->balls[b];
+        Vector2 position = { ball->position.x, ball->position.y };
+
+        if (trail->length > 0) {
+            // A different ball in this slot, or one that was put somewhere: start over
+            Vector2 last = trail->points[trail->head];
+            float maxStep = sqrtf(ball->speed.x * ball->speed.x + ball->speed.y * ball->speed.y) * SIM_DT * 2.0f + ball->radius;
+            float dx = position.x - last.x;
+            float dy = position.y - last.y;
+            if (dx * dx + dy * dy > maxStep * maxStep) trail->length = 0;
+        }
+
+        trail->head = (trail->length > 0) ? (trail->head + 1) % BALL_TRAIL_POINTS : 0;
+        trail->points[trail->head] = position;
+        if (trail->length < BALL_TRAIL_POINTS) trail->length++;
+    }
+}
+
+// Vertex with its own color, so a quad can fade along its length
+static void PushColoredVertex(Vector2 position, unsigned char alpha, float u, float v) {
+    rlColor4ub(255, 255, 255, alpha);
+    rlTexCoord2f(u, v);
+    rlVertex2f(position.x, position.y);
+}
+
+void DrawBallTrails(const BallTrails *trails, const SimState *sim, float alpha, Vector2 offset) {
+    QuadCoords uv = GetShapesCoords();
+    rlSetTexture(GetShapesTexture().id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    int count = (trails->count < sim->ballCount) ? trails->count : sim->ballCount;
+    for (int b = 0; b < count; b++) {
+        const BallTrail *trail = &trails->trails[b];
+        float radius = sim->balls[b].radius;
+        int segments = trail->length - 1;
+        for (int k = 0; k < segments; k++) {
+            // Segment from point k (k ticks old) to point k + 1
+            Vector2 a = trail->points[(trail->head - k + BALL_TRAIL_POINTS) % BALL_TRAIL_POINTS];
+            Vector2 c = trail->points[(trail->head - k - 1 + BALL_TRAIL_POINTS) % BALL_TRAIL_POINTS];
+            if (k == 0) a = (Vector2){ c.x + (a.x - c.x) * alpha, c.y + (a.y - c.y) * alpha };
+            float dx = c.x - a.x;
+            float dy = c.y - a.y;
+            float length = sqrtf(dx * dx + dy * dy);
+            if (length < 0.01f) continue;
+
+            float fadeA = 1.0f - (float)k / segments;
+            float fadeC = 1.0f - (float)(k + 1) / segments;
+            float nx = -dy / length;
+            float ny = dx / length;
+            float widthA = radius * TRAIL_HALF_WIDTH * fadeA;
+            float widthC = radius * TRAIL_HALF_WIDTH * fadeC;
+            unsigned char alphaA = (unsigned char)(TRAIL_ALPHA * fadeA);
+            unsigned char alphaC = (unsigned char)(TRAIL_ALPHA * fadeC);
+
+            Vector2 v0 = { a.x + nx * widthA + offset.x, a.y + ny * widthA + offset.y };
+            Vector2 v1 = { c.x + nx * widthC + offset.x, c.y + ny * widthC + offset.y };
+            Vector2 v2 = { c.x - nx * widthC + offset.x, c.y - ny * widthC + offset.y };
+            Vector2 v3 = { a.x - nx * widthA + offset.x, a.y - ny * widthA + offset.y };
+
+            // Wind every quad the way raylib's rectangles are, whichever way the ball went
+            if (rlCheckRenderBatchLimit(4)) renderDrawCalls++;
+            if ((v1.x - v0.x) * (v3.y - v0.y) - (v1.y - v0.y) * (v3.x - v0.x) < 0.0f) {
+                PushColoredVertex(v0, alphaA, uv.u0, uv.v0);
+                PushColoredVertex(v1, alphaC, uv.u0, uv.v1);
+                PushColoredVertex(v2, alphaC, uv.u1, uv.v1);
+                PushColoredVertex(v3, alphaA, uv.u1, uv.v0);
+            } else {
+                PushColoredVertex(v3, alphaA, uv.u0, uv.v0);
+                PushColoredVertex(v2, alphaC, uv.u0, uv.v1);
+                PushColoredVertex(v1, alphaC, uv.u1, uv.v1);
+                PushColoredVertex(v0, alphaA, uv.u1, uv.v0);
+            }
+        }
+    }
+    rlEnd();
+    rlSetTexture(0);
+    renderDrawCalls++;
+}
+
+bool InitSimMotion(SimMotion *motion, int capacity) {
+    *motion = (SimMotion){ 0 };
+    motion->balls = calloc((size_t)capacity, sizeof(Vector2));
+    motion->capacity = (motion->balls != NULL) ? capacity : 0;
+    return motion->balls != NULL;
+}
+
+void FreeSimMotion(SimMotion *motion) {
+    free(motion->balls);
+    *motion = (SimMotion){ 0 };
+}
+
+void CaptureSimMotion(SimMotion *motion, const SimState *sim) {
+    motion->ballCount = (sim->ballCount < motion->capacity) ? sim->ballCount : motion->capacity;
+    for (int b = 0; b < motion->ballCount; b++) {
+        motion->balls[b] = (Vector2){ sim->balls[b].position.x, sim->balls[b].position.y };
+    }
+    motion->paddle = sim->paddle;
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        motion->powerups[i] = sim->powerups[i].rect;
+        motion->powerupActive[i] = sim->powerups[i].active;
+    }
+    motion->tick = sim->tick;
+}
+
+// Positions from before the latest tick, if that is what the motion holds
+static bool IsSimMotionCurrent(const SimMotion *motion, const SimState *sim) {
+    return motion->tick + 1 == sim->tick;
+}
+
+// from + (to - from) * alpha, or to when the move is longer than maxStep
+static float LerpStep(float from, float to, float alpha, float maxStep) {
+    return (fabsf(to - from) > maxStep) ? to : from + (to - from) * alpha;
+}
+
+Vector2 GetBallDrawPosition(const SimMotion *motion, const SimState *sim, int ball, float alpha) {
+    const Ball *current = &sim->balls[ball];
+    Vector2 position = { current->position.x, current->position.y };
+    if (!IsSimMotionCurrent(motion, sim) || ball >= motion->ballCount) return position;
+
+    // A different ball in this slot (swap-removed), or one that was put somewhere
+    Vector2 last = motion->balls[ball];
+    float maxStep = sqrtf(current->speed.x * current->speed.x + current->speed.y * current->speed.y) * SIM_DT * 2.0f + current->radius;
+    float dx = position.x - last.x;
+    float dy = position.y - last.y;
+    if (dx * dx + dy * dy > maxStep * maxStep) return position;
+    return (Vector2){ last.x + dx * alpha, last.y + dy * alpha };
+}
+
+Rectangle GetPaddleDrawRect(const SimMotion *motion, const SimState *sim, float alpha) {
+    Rectangle rect = { sim->paddle.x, sim->paddle.y, sim->paddle.width, sim->paddle.height };
+    if (!IsSimMotionCurrent(motion, sim)) return rect;
+    // Buffs change the width in one tick; the centre is what moves
+    float lastCenter = motion->paddle.x + motion->paddle.width / 2.0f;
+    float center = LerpStep(lastCenter, rect.x + rect.width / 2.0f, alpha, PADDLE_SPEED * SIM_DT * 2.0f);
+    rect.x = center - rect.width / 2.0f;
+    return rect;
+}
+
+Rectangle GetPowerUpDrawRect(const SimMotion *motion, const SimState *sim, int powerup, float alpha) {
+    const SimRect *current = &sim->powerups[powerup].rect;
+    Rectangle rect = { current->x, current->y, current->width, current->height };
+    if (!IsSimMotionCurrent(motion, sim) || !motion->powerupActive[powerup]) return rect;
+    float maxStep = POWERUP_SPEED * SIM_DT * 2.0f;
+    const SimRect *last = &motion->powerups[powerup];
+    if (fabsf(current->x - last->x) > maxStep) return rect;  // A new power-up in a reused slot
+    rect.y = LerpStep(last->y, current->y, alpha, maxStep);
+    return rect;
+}
+
+bool PrepareCanvas(Canvas *canvas, int width, int height, int scalePercent) {
+    // A failed target is only retried at another size
+    if (canvas->width != width || canvas->height != height || canvas->scalePercent != scalePercent) {
+        if (IsRenderTextureReady(canvas->target)) UnloadRenderTexture(canvas->target);
+        canvas->width = width;
+        canvas->height = height;
+        canvas->scalePercent = scalePercent;
+        canvas->target = LoadRenderTexture(width * scalePercent / 100, height * scalePercent / 100);
+        if (IsRenderTextureReady(canvas->target)) SetTextureFilter(canvas->target.texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    // Largest fit in the window, centered
+    float windowWidth = (float)GetScreenWidth();
+    float windowHeight = (float)GetScreenHeight();
+    float fit = fminf(windowWidth / width, windowHeight / height);
+    canvas->view.width = width * fit;
+    canvas->view.height = height * fit;
+    canvas->view.x = floorf((windowWidth - canvas->view.width) / 2.0f);
+    canvas->view.y = floorf((windowHeight - canvas->view.height) / 2.0f);
+    return IsRenderTextureReady(canvas->target);
+}
+
+void MapMouseToCanvas(const Canvas *canvas) {
+    if (canvas->view.width <= 0.0f || canvas->view.height <= 0.0f) return;
+    SetMouseOffset((int)-canvas->view.x, (int)-canvas->view.y);
+    SetMouseScale(canvas->width / canvas->view.width, canvas->height / canvas->view.height);
+}
+
+void BeginCanvasFrame(const Canvas *canvas) {
+    Camera2D camera = { 0 };
+    if (IsRenderTextureReady(canvas->target)) {
+        BeginTextureMode(canvas->target);
+        camera.zoom = (float)canvas->target.texture.width / canvas->width;
+    } else {
+        // Same letterboxing, drawn at window resolution
+        BeginDrawing();
+        ClearBackground(BLACK);
+        camera.offset = (Vector2){ canvas->view.x, canvas->view.y };
+        camera.zoom = canvas->view.width / canvas->width;
+    }
+    BeginMode2D(camera);
+}
+
+void EndCanvasFrame(const Canvas *canvas) {
+    EndMode2D();
+    if (!IsRenderTextureReady(canvas->target)) {
+        EndDrawing();
+        return;
+    }
+    EndTextureMode();
+
+    BeginDrawing();
+    ClearBackground(BLACK);
+    // Copy, not blend: translucent draws leave the canvas' own alpha below 255
+    rlSetBlendFactors(RL_ONE, RL_ZERO, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM);
+    Rectangle source = { 0.0f, 0.0f, (float)canvas->target.texture.width, -(float)canvas->target.texture.height };
+    DrawTextureProCounted(canvas->target.texture, source, canvas->view, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    EndBlendMode();
+    EndDrawing();
+}
+
+void UnloadCanvas(Canvas *canvas) {
+    if (IsRenderTextureReady(canvas->target)) UnloadRenderTexture(canvas->target);
+    *canvas = (Canvas){ 0 };
+}
+
+bool LoadHudIcons(void) {
+    // Entries side by side in one row
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+    for (int icon = 0; icon < HUD_ICON_COUNT; icon++) {
+        atlasWidth += hudIconArt[icon].width + HUD_ICON_PADDING;
+        if (hudIconArt[icon].height > atlasHeight) atlasHeight = hudIconArt[icon].height;
+    }
+
+    Image atlas = GenImageColor(atlasWidth, atlasHeight, BLANK);
+    int x = 0;
+    for (int icon = 0; icon < HUD_ICON_COUNT; icon++) {
+        const HudIconArt *art = &hudIconArt[icon];
+        for (int row = 0; row < art->height; row++) {
+            for (int col = 0; col < art->width; col++) {
+                if (art->rows[row][col] == 'X') ImageDrawPixel(&atlas, x + col, row, WHITE);
+            }
+        }
+        hudIconSource[icon] = (Rectangle){ (float)x, 0.0f, (float)art->width, (float)art->height };
+        x += art->width + HUD_ICON_PADDING;
+    }
+
+    hudIconAtlas = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+    if (!IsTextureReady(hudIconAtlas)) return false;
+    SetTextureFilter(hudIconAtlas, TEXTURE_FILTER_POINT);
+    return true;
+}
+
+void UnloadHudIcons(void) {
+    if (IsTextureReady(hudIconAtlas)) UnloadTexture(hudIconAtlas);
+    hudIconAtlas = (Texture2D){ 0 };
+}
+
+Vector2 GetHudIconSize(HudIcon icon, float pixelSize) {
+    return (Vector2){ hudIconSource[icon].width * pixelSize, hudIconSource[icon].height * pixelSize };
+}
+
+void DrawHudIcon(HudIcon icon, Vector2 position, float pixelSize, Color tint) {
+    Vector2 size = GetHudIconSize(icon, pixelSize);
+    Rectangle dest = { position.x, position.y, size.x, size.y };
+    DrawTextureProCounted(hudIconAtlas, hudIconSource[icon], dest, (Vector2){ 0.0f, 0.0f }, 0.0f, tint);
+}
+
+// FNV-1a over the string and the font size, never 0 (the empty-slot marker)
+static uint32_t HashText(const char *text, int fontSize, size_t *length) {
+    uint32_t hash = 2166136261u ^ (uint32_t)fontSize;
+    const char *c = text;
+    for (; *c != '\0'; c++) hash = (hash ^ (uint8_t)*c) * 16777619u;
+    *length = (size_t)(c - text);
+    return (hash != 0) ? hash : 1;
+}
+
+int MeasureTextCached(const char *text, int fontSize) {
+    size_t length;
+    uint32_t hash = HashText(text, fontSize, &length);
+    if (length >= TEXT_MEASURE_LENGTH) return MeasureText(text, fontSize);
+
+    TextMeasure *slot = NULL;
+    for (int probe = 0; probe < TEXT_MEASURE_PROBES; probe++) {
+        TextMeasure *entry = &textMeasures[(hash + probe) & (TEXT_MEASURE_SLOTS - 1)];
+        if (entry->hash == hash && entry->fontSize == fontSize && strcmp(entry->text, text) == 0) return entry->width;
+        if (entry->hash == 0 && slot == NULL) slot = entry;
+    }
+    if (slot == NULL) slot = &textMeasures[hash & (TEXT_MEASURE_SLOTS - 1)];  // Evict the home slot
+
+    slot->hash = hash;
+    slot->fontSize = fontSize;
+    slot->width = MeasureText(text, fontSize);
+    memcpy(slot->text, text, length + 1);
+    return slot->width;
+}
+
+const char *FormatCachedText(CachedText *cache, int64_t key, int fontSize, const char *format, ...) {
+    if (cache->valid && cache->key == key && cache->fontSize == fontSize) return cache->text;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(cache->text, sizeof(cache->text), format, args);
+    va_end(args);
+    cache->width = MeasureText(cache->text, fontSize);
+    cache->fontSize = fontSize;
+    cache->key = key;
+    cache->valid = true;
+    return cache->text;
+}
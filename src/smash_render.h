@@ -0,0 +1,131 @@
+// Smash Out! rendering helpers: batched brick field and cached brick layer, HUD icon
+// atlas, ball trails, interpolation between ticks, the scaled virtual canvas and
+// text caches.
+
+#ifndef SMASH_RENDER_H
+#define SMASH_RENDER_H
+
+#include <stdint.h>
+#include <raylib.h>
+#include "smash_sim.h"
+
+// raylib draw calls issued this frame: one per *Counted wrapper call, and one per
+// batched helper here (brick field, ball trails). The caller resets it every frame.
+extern int renderDrawCalls;
+
+void DrawRectangleCounted(int posX, int posY, int width, int height, Color color);
+void DrawRectangleRecCounted(Rectangle rec, Color color);
+void DrawRectangleLinesCounted(int posX, int posY, int width, int height, Color color);
+void DrawLineCounted(int startPosX, int startPosY, int endPosX, int endPosY, Color color);
+void DrawCircleCounted(int centerX, int centerY, float radius, Color color);
+void DrawCircleVCounted(Vector2 center, float radius, Color color);
+void DrawTextCounted(const char *text, int posX, int posY, int fontSize, Color color);
+void DrawTextureRecCounted(Texture2D texture, Rectangle source, Vector2 position, Color tint);
+void DrawTextureProCounted(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+
+void InitBrickPalette(void);
+Color GetBrickColor(const BrickField *field, int index);
+void DrawBrickField(const BrickField *field, Vector2 offset);
+
+typedef struct BrickLayer {
+    RenderTexture2D target;
+    Rectangle bounds;       // Canvas area the texture covers
+    int scalePercent;       // Texture pixels per canvas pixel, as on the canvas
+    BoardLayout layout;     // Layout it was drawn for
+    int count;
+    int capacity;           // Bricks the copies below can hold
+    uint32_t *active;       // The field as drawn in the texture
+    uint32_t *discovered;
+    uint8_t *type;
+    uint8_t *health;
+    bool valid;
+    int redrawn;            // Bricks redrawn by the last update
+} BrickLayer;
+
+// Bring the texture up to date with field, at the canvas' render scale; call outside
+// BeginDrawing/EndDrawing. False if the texture or the copies couldn't be allocated
+// (draw the field directly).
+bool UpdateBrickLayer(BrickLayer *layer, const BrickField *field, int scalePercent);
+void DrawBrickLayer(const BrickLayer *layer, Vector2 offset);
+void UnloadBrickLayer(BrickLayer *layer);
+
+typedef enum HudIcon {
+    HUD_ICON_HEART,
+    HUD_ICON_COUNT
+} HudIcon;
+
+bool LoadHudIcons(void);  // Needs the window; false if the atlas couldn't be created
+void UnloadHudIcons(void);
+Vector2 GetHudIconSize(HudIcon icon, float pixelSize);
+void DrawHudIcon(HudIcon icon, Vector2 position, float pixelSize, Color tint);
+
+#define BALL_TRAIL_POINTS 8  // Positions kept per ball, one per tick: 1/15 s of travel
+
+typedef struct BallTrail {
+    Vector2 points[BALL_TRAIL_POINTS];  // Ring buffer, newest at head
+    int head;
+    int length;
+} BallTrail;
+
+typedef struct BallTrails {
+    BallTrail *trails;  // One per ball slot
+    int capacity;
+    int count;          // Slots recorded on the last tick
+} BallTrails;
+
+bool InitBallTrails(BallTrails *trails, int capacity);
+void FreeBallTrails(BallTrails *trails);
+void ClearBallTrails(BallTrails *trails);
+void RecordBallTrails(BallTrails *trails, const SimState *sim);  // After every tick
+// The newest segment ends alpha of the way along the last tick, where the ball is drawn
+void DrawBallTrails(const BallTrails *trails, const SimState *sim, float alpha, Vector2 offset);
+
+typedef struct SimMotion {
+    Vector2 *balls;     // Ball positions per slot, before the latest tick
+    int capacity;
+    int ballCount;
+    SimRect paddle;
+    SimRect powerups[MAX_POWERUPS];
+    bool powerupActive[MAX_POWERUPS];
+    uint64_t tick;      // Tick the positions are from (valid while it is sim->tick - 1)
+} SimMotion;
+
+bool InitSimMotion(SimMotion *motion, int capacity);
+void FreeSimMotion(SimMotion *motion);
+void CaptureSimMotion(SimMotion *motion, const SimState *sim);  // Before every tick
+Vector2 GetBallDrawPosition(const SimMotion *motion, const SimState *sim, int ball, float alpha);
+Rectangle GetPaddleDrawRect(const SimMotion *motion, const SimState *sim, float alpha);
+Rectangle GetPowerUpDrawRect(const SimMotion *motion, const SimState *sim, int powerup, float alpha);
+
+typedef struct Canvas {
+    RenderTexture2D target;
+    int width;          // Virtual size everything is laid out in
+    int height;
+    int scalePercent;   // Render scale the target was created at
+    Rectangle view;     // Where the canvas lands in the window
+} Canvas;
+
+// (Re)create the target when the scale changed; call outside BeginDrawing/EndDrawing.
+// False if the texture couldn't be created (frames then draw straight to the window).
+bool PrepareCanvas(Canvas *canvas, int width, int height, int scalePercent);
+void MapMouseToCanvas(const Canvas *canvas);  // After PrepareCanvas, before reading the mouse
+void BeginCanvasFrame(const Canvas *canvas);  // In place of BeginDrawing
+void EndCanvasFrame(const Canvas *canvas);    // In place of EndDrawing: presents the canvas
+void UnloadCanvas(Canvas *canvas);
+
+#define CACHED_TEXT_LENGTH 96
+
+typedef struct CachedText {
+    char text[CACHED_TEXT_LENGTH];
+    int width;     // MeasureText(text, fontSize)
+    int fontSize;
+    int64_t key;   // Values the text was formatted from
+    bool valid;
+} CachedText;
+
+int MeasureTextCached(const char *text, int fontSize);
+// Reformat (printf-style) and remeasure only when key or fontSize differs from last time.
+// The key must determine the text: format values from it (e.g. tenths, not the float).
+const char *FormatCachedText(CachedText *cache, int64_t key, int fontSize, const char *format, ...);
+
+#endif // SMASH_RENDER_H
@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "smash_replay.h"
+
+#define REPLAY_HEADER_SIZE 44
+#define REPLAY_FLAG_HASHES 0x0001
+
+static bool GrowRuns(Replay *replay, size_t extra) {
+    if (replay->runBytes + extra <= replay->runCapacity) return true;
+    size_t capacity = replay->runCapacity ? replay->runCapacity * 2 : 256;
+    while (capacity < replay->runBytes + extra) capacity *= 2;
+    uint8_t *runs = realloc(replay->runs, capacity);
+    if (runs == NULL) return false;
+    replay->runs = runs;
+    replay->runCapacity = capacity;
+    return true;
+}
+
+// Append the pending run: buttons byte, then the length as a LEB128 varint
+static bool FlushRun(Replay *replay) {
+    if (replay->pendingLength == 0) return true;
+    if (!GrowRuns(replay, 6)) return false;
+    replay->runs[replay->runBytes++] = replay->pendingButtons;
+    uint32_t length = replay->pendingLength;
+    while (length >= 0x80) {
+        replay->runs[replay->runBytes++] = (uint8_t)(length | 0x80);
+        length >>= 7;
+    }
+    replay->runs[replay->runBytes++] = (uint8_t)length;
+    replay->pendingLength = 0;
+    return true;
+}
+
+void BeginReplay(Replay *replay, const SimState *sim, uint32_t hashInterval) {
+    FreeReplay(replay);
+    replay->seed = sim->config.seed;
+    replay->startLevel = sim->level;
+    replay->config = sim->config;
+    replay->hashInterval = hashInterval;
+}
+
+bool RecordReplayTick(Replay *replay, SimInput input, const SimState *sim) {
+    if (replay->pendingLength > 0 && input.buttons != replay->pendingButtons) {
+        if (!FlushRun(replay)) return false;
+    }
+    replay->pendingButtons = input.buttons;
+    replay->pendingLength++;
+    replay->tickCount++;
+
+    if (replay->hashInterval > 0 && replay->tickCount % replay->hashInterval == 0) {
+        if (replay->hashCount == replay->hashCapacity) {
+            uint32_t capacity = replay->hashCapacity ? replay->hashCapacity * 2 : 64;
+            uint32_t *hashes = realloc(replay->hashes, capacity * sizeof(uint32_t));
+            if (hashes == NULL) return false;
+            replay->hashes = hashes;
+            replay->hashCapacity = capacity;
+        }
+        replay->hashes[replay->hashCount++] = (uint32_t)HashSimState(sim);
+    }
+    return true;
+}
+
+// Decode the LEB128 length that follows a run's buttons byte; false if it is truncated
+static bool ReadRunLength(const Replay *replay, size_t *offset, uint32_t *length) {
+    *length = 0;
+    for (int shift = 0; *offset < replay->runBytes && shift <= 28; shift += 7) {
+        uint8_t byte = replay->runs[(*offset)++];
+        *length |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return *length > 0;
+    }
+    return false;
+}
+
+// Cut the recording back to its first tickCount ticks (rewind, level restart). The run
+// holding the last kept tick goes back to being the pending run.
+bool TruncateReplay(Replay *replay, uint32_t tickCount) {
+    if (tickCount >= replay->tickCount) return tickCount == replay->tickCount;
+    if (!FlushRun(replay)) return false;
+
+    size_t offset = 0;
+    uint32_t tick = 0;
+    while (offset < replay->runBytes) {
+        size_t runStart = offset;
+        uint8_t buttons = replay->runs[offset++];
+        uint32_t length;
+        if (!ReadRunLength(replay, &offset, &length)) return false;
+        if (tick + length >= tickCount) {
+            replay->runBytes = runStart;
+            replay->pendingButtons = buttons;
+            replay->pendingLength = tickCount - tick;
+            break;
+        }
+        tick += length;
+    }
+    replay->tickCount = tickCount;
+    if (replay->hashInterval > 0 && replay->hashCount > tickCount / replay->hashInterval) {
+        replay->hashCount = tickCount / replay->hashInterval;
+    }
+    return true;
+}
+
+void FreeReplay(Replay *replay) {
+    free(replay->runs);
+    free(replay->hashes);
+    memset(replay, 0, sizeof(*replay));
+}
+
+// Little-endian field writers/readers over a byte cursor
+static uint8_t *Put(uint8_t *at, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) *at++ = (uint8_t)(value >> (8 * i));
+    return at;
+}
+
+static const uint8_t *Get(const uint8_t *at, uint64_t *value, int bytes) {
+    *value = 0;
+    for (int i = 0; i < bytes; i++) *value |= (uint64_t)at[i] << (8 * i);
+    return at + bytes;
+}
+
+// File layout (little endian):
+//   "SMRP"  u16 version  u16 flags  u64 seed  u16 startLevel
+//   u16 boardCols  u16 boardRows  u8 massiveMultiball  u16 startBalls
+//   u8 blastRadius  u16 chainBudget
+//   u32 tickCount  u32 hashInterval  u32 runBytes  u32 hashCount
+//   runBytes bytes of input runs, then hashCount u32 hashes
+bool SaveReplay(Replay *replay, const char *path) {
+    if (!FlushRun(replay)) return false;
+
+    uint8_t header[REPLAY_HEADER_SIZE] = { 'S', 'M', 'R', 'P' };
+    uint8_t *at = header + 4;
+    at = Put(at, REPLAY_VERSION, 2);
+    at = Put(at, replay->hashInterval > 0 ? REPLAY_FLAG_HASHES : 0, 2);
+    at = Put(at, replay->seed, 8);
+    at = Put(at, (uint64_t)replay->startLevel, 2);
+    at = Put(at, (uint64_t)replay->config.customBoard.cols, 2);
+    at = Put(at, (uint64_t)replay->config.customBoard.rows, 2);
+    at = Put(at, replay->config.massiveMultiball ? 1 : 0, 1);
+    at = Put(at, (uint64_t)replay->config.startBalls, 2);
+    at = Put(at, (uint64_t)replay->config.blastRadius, 1);
+    at = Put(at, (uint64_t)replay->config.chainBudget, 2);
+    at = Put(at, replay->tickCount, 4);
+    at = Put(at, replay->hashInterval, 4);
+    at = Put(at, replay->runBytes, 4);
+    at = Put(at, replay->hashCount, 4);
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return false;
+    bool ok = fwrite(header, 1, REPLAY_HEADER_SIZE, file) == REPLAY_HEADER_SIZE &&
+              fwrite(replay->runs, 1, replay->runBytes, file) == replay->runBytes;
+    for (uint32_t i = 0; ok && i < replay->hashCount; i++) {
+        uint8_t hash[4];
+        Put(hash, replay->hashes[i], 4);
+        ok = fwrite(hash, 1, 4, file) == 4;
+    }
+    return (fclose(file) == 0) && ok;
+}
+
+bool LoadReplay(Replay *replay, const char *path) {
+    memset(replay, 0, sizeof(*replay));
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return false;
+
+    uint8_t header[REPLAY_HEADER_SIZE];
+    uint64_t magic, version, flags, value, runBytes, hashCount;
+    const uint8_t *at = header;
+    bool ok = fread(header, 1, REPLAY_HEADER_SIZE, file) == REPLAY_HEADER_SIZE;
+    if (ok) {
+        at = Get(at, &magic, 4);
+        at = Get(at, &version, 2);
+        ok = magic == ('S' | 'M' << 8 | 'R' << 16 | (uint64_t)'P' << 24) && version == REPLAY_VERSION;
+    }
+    if (ok) {
+        at = Get(at, &flags, 2);
+        at = Get(at, &replay->seed, 8);
+        at = Get(at, &value, 2); replay->startLevel = (int)value;
+        uint64_t cols, rows;
+        at = Get(at, &cols, 2);
+        at = Get(at, &rows, 2);
+        if (cols > 0 && rows > 0) replay->config.customBoard = MakeFittedLayout((int)cols, (int)rows);
+        at = Get(at, &value, 1); replay->config.massiveMultiball = value != 0;
+        at = Get(at, &value, 2); replay->config.startBalls = (int)value;
+        at = Get(at, &value, 1); replay->config.blastRadius = (int)value;
+        at = Get(at, &value, 2); replay->config.chainBudget = (int)value;
+        at = Get(at, &value, 4); replay->tickCount = (uint32_t)value;
+        at = Get(at, &value, 4); replay->hashInterval = (flags & REPLAY_FLAG_HASHES) ? (uint32_t)value : 0;
+        at = Get(at, &runBytes, 4);
+        at = Get(at, &hashCount, 4);
+        replay->config.seed = replay->seed;
+
+        replay->runs = malloc(runBytes ? runBytes : 1);
+        replay->hashes = malloc(hashCount ? hashCount * sizeof(uint32_t) : 1);
+        ok = replay->runs != NULL && replay->hashes != NULL &&
+             fread(replay->runs, 1, runBytes, file) == runBytes;
+        replay->runBytes = replay->runCapacity = runBytes;
+        replay->hashCount = replay->hashCapacity = (uint32_t)hashCount;
+    }
+    for (uint32_t i = 0; ok && i < replay->hashCount; i++) {
+        uint8_t hash[4];
+        ok = fread(hash, 1, 4, file) == 4;
+        Get(hash, &value, 4);
+        replay->hashes[i] = (uint32_t)value;
+    }
+    fclose(file);
+
+    if (!ok) FreeReplay(replay);
+    return ok;
+}
+
+bool StartReplayGame(const Replay *replay, SimState *sim) {
+    sim->config = replay->config;
+    sim->config.seed = replay->seed;
+    if (!StartGame(sim)) return false;
+    if (replay->startLevel > 1) return LoadLevel(sim, replay->startLevel);
+    return true;
+}
+
+void BeginReplayReader(ReplayReader *reader, const Replay *replay) {
+    memset(reader, 0, sizeof(*reader));
+    reader->replay = replay;
+}
+
+bool NextReplayInput(ReplayReader *reader, SimInput *input) {
+    const Replay *replay = reader->replay;
+    if (reader->tick >= replay->tickCount) return false;
+
+    if (reader->remaining == 0) {
+        // Decode the next run; a truncated stream ends the replay
+        if (reader->offset >= replay->runBytes) return false;
+        reader->buttons = replay->runs[reader->offset++];
+        if (!ReadRunLength(replay, &reader->offset, &reader->remaining)) return false;
+    }
+
+    input->buttons = reader->buttons;
+    reader->remaining--;
+    reader->tick++;
+    return true;
+}
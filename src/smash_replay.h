@@ -0,0 +1,54 @@
+// Smash Out! input replays: seed, config and run-length encoded per-tick inputs, with
+// periodic state hashes to find where a playback diverges. Pure C99.
+
+#ifndef SMASH_REPLAY_H
+#define SMASH_REPLAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "smash_sim.h"
+
+#define REPLAY_VERSION 1
+
+typedef struct Replay {
+    uint64_t seed;
+    int startLevel;
+    SimConfig config;        // Board size, multiball and chain settings (seed lives above)
+    uint32_t tickCount;
+    uint32_t hashInterval;   // 0 = no hashes
+
+    uint8_t *runs;           // Encoded input runs
+    size_t runBytes;
+    size_t runCapacity;
+    uint32_t *hashes;        // hashes[k] is the state hash after tick (k + 1) * hashInterval
+    uint32_t hashCount;
+    uint32_t hashCapacity;
+
+    // Recording: the run still being extended
+    uint8_t pendingButtons;
+    uint32_t pendingLength;
+} Replay;
+
+typedef struct ReplayReader {
+    const Replay *replay;
+    size_t offset;           // Next byte in runs
+    uint8_t buttons;         // Current run
+    uint32_t remaining;      // Ticks left in the current run
+    uint32_t tick;           // Ticks handed out so far
+} ReplayReader;
+
+// Recording
+void BeginReplay(Replay *replay, const SimState *sim, uint32_t hashInterval);  // Call right after StartGame
+bool RecordReplayTick(Replay *replay, SimInput input, const SimState *sim);    // Call after each StepSimulation
+bool TruncateReplay(Replay *replay, uint32_t tickCount);  // Keep the first tickCount ticks (after a rewind)
+bool SaveReplay(Replay *replay, const char *path);
+void FreeReplay(Replay *replay);
+
+// Playback
+bool LoadReplay(Replay *replay, const char *path);
+bool StartReplayGame(const Replay *replay, SimState *sim);  // Config, seed and start level from the replay
+void BeginReplayReader(ReplayReader *reader, const Replay *replay);
+bool NextReplayInput(ReplayReader *reader, SimInput *input);  // false after the last tick; call LoadLevel(level + 1) after a cleared level, as the game does
+
+#endif // SMASH_REPLAY_H
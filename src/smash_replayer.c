@@ -0,0 +1,167 @@
+// Smash Out! replay runner
+//
+// Re-simulates a recorded game (see smash_replay.h) as fast as the simulation runs,
+// with no window, audio or frame pacing, and checks the state hashes stored in the
+// file. A mismatch means the simulation no longer plays the recording the same way;
+// the runner reports the first tick known to diverge and exits with status 2.
+//
+// Usage: smash_replayer FILE [--trace] [--snapshots]
+// --trace prints the state hash after every tick, so two builds can be diffed to find
+// the exact tick where they part ways.
+// --snapshots also captures a rewind snapshot after every tick, as the game does, and
+// reports what that costs; afterwards it rewinds through the whole ring and checks that
+// every restored state matches the one that was captured.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "smash_replay.h"
+#include "smash_snapshot.h"
+
+// Same history as the game keeps for rewinding
+#define SNAPSHOT_ARENA_BYTES (8 * 1024 * 1024)
+#define SNAPSHOT_MAX_RECORDS (SIM_TICK_RATE * 20)
+#define SNAPSHOT_KEYFRAME_INTERVAL 60
+#define SNAPSHOT_REWIND_STEP 7  // Records skipped between checks while rewinding the ring
+
+static double GetSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = NULL;
+    bool trace = false;
+    bool snapshots = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0) {
+            trace = true;
+        } else if (strcmp(argv[i], "--snapshots") == 0) {
+            snapshots = true;
+        } else if (path == NULL && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (path == NULL) {
+        fprintf(stderr, "usage: smash_replayer FILE [--trace] [--snapshots]\n");
+        return 1;
+    }
+
+    static Replay replay;
+    if (!LoadReplay(&replay, path)) {
+        fprintf(stderr, "smash_replayer: %s is not a readable version %d replay\n", path, REPLAY_VERSION);
+        return 1;
+    }
+
+    static SimState sim;
+    static SimEventList events;
+    if (!StartReplayGame(&replay, &sim)) {
+        fprintf(stderr, "smash_replayer: out of memory\n");
+        return 1;
+    }
+
+    printf("Replaying %s: seed %llu, level %d, %u ticks, %u hashes\n", path, (unsigned long long)replay.seed,
+           replay.startLevel, replay.tickCount, replay.hashCount);
+
+    // Snapshot history, plus the hash of every tick to check restored states against
+    static SnapshotRing ring;
+    uint32_t *tickHashes = NULL;
+    double snapshotSeconds = 0.0;
+    unsigned long long snapshotBytes = 0;
+    if (snapshots) {
+        tickHashes = malloc(((size_t)replay.tickCount + 1) * sizeof(uint32_t));
+        if (tickHashes == NULL || !InitSnapshotRing(&ring, SNAPSHOT_ARENA_BYTES, SNAPSHOT_MAX_RECORDS, SNAPSHOT_KEYFRAME_INTERVAL)) {
+            fprintf(stderr, "smash_replayer: out of memory\n");
+            return 1;
+        }
+        tickHashes[0] = (uint32_t)HashSimState(&sim);
+        CaptureSnapshot(&ring, &sim);
+    }
+
+    ReplayReader reader;
+    BeginReplayReader(&reader, &replay);
+    SimInput input;
+    uint32_t ticks = 0;
+    uint32_t hashesChecked = 0;
+    long long divergedTick = -1;
+    double start = GetSeconds();
+    while (sim.status != SIM_GAME_OVER && NextReplayInput(&reader, &input)) {
+        // The game loads the next level between the summary screen and the next tick
+        if (sim.status == SIM_LEVEL_CLEARED && !LoadLevel(&sim, sim.level + 1)) break;
+        StepSimulation(&sim, input, &events);
+        ticks++;
+
+        if (trace) printf("%u %08x\n", ticks, (uint32_t)HashSimState(&sim));
+        if (snapshots) {
+            double captureStart = GetSeconds();
+            CaptureSnapshot(&ring, &sim);
+            snapshotSeconds += GetSeconds() - captureStart;
+            snapshotBytes += ring.records[(ring.first + ring.count - 1) % ring.recordCapacity].recordBytes;
+            tickHashes[ticks] = (uint32_t)HashSimState(&sim);
+        }
+        if (replay.hashInterval > 0 && ticks % replay.hashInterval == 0) {
+            uint32_t k = ticks / replay.hashInterval - 1;
+            if (k < replay.hashCount) {
+                hashesChecked++;
+                if ((uint32_t)HashSimState(&sim) != replay.hashes[k]) {
+                    // Only sampled ticks are hashed, so the divergence began after the previous sample
+                    divergedTick = ticks;
+                    break;
+                }
+            }
+        }
+    }
+    double elapsed = GetSeconds() - start;
+
+    printf("%u ticks (%.1f game seconds) in %.3fs, %.2fM ticks/s\n", ticks, ticks * SIM_DT, elapsed,
+           (elapsed > 0.0) ? ticks / elapsed / 1e6 : 0.0);
+    printf("Final: level %d, score %d, lives %d%s\n", sim.level, sim.score, sim.lives,
+           (sim.status == SIM_GAME_OVER) ? ", game over" : "");
+
+    int result = 0;
+    if (snapshots && ticks > 0) {
+        printf("Snapshots: %.2f us per capture, %.0f bytes per record, %d records (%.1f s) held in %d KB\n",
+               snapshotSeconds / (ticks + 1) * 1e6, (double)snapshotBytes / ticks, ring.count,
+               ring.count * SIM_DT, SNAPSHOT_ARENA_BYTES / 1024);
+
+        // Rewind through the ring; each restore drops the records after it
+        int restores = 0;
+        double restoreSeconds = 0.0;
+        while (ring.count > SNAPSHOT_REWIND_STEP) {
+            double restoreStart = GetSeconds();
+            bool restored = RestoreSnapshot(&ring, SNAPSHOT_REWIND_STEP, &sim);
+            restoreSeconds += GetSeconds() - restoreStart;
+            if (!restored || (uint32_t)HashSimState(&sim) != tickHashes[sim.tick]) {
+                printf("SNAPSHOT MISMATCH: restoring tick %llu\n", (unsigned long long)sim.tick);
+                result = 3;
+                break;
+            }
+            restores++;
+        }
+        if (restores > 0) {
+            printf("Rewind: %d restores matched, %.2f us per restore\n", restores, restoreSeconds / restores * 1e6);
+        }
+    }
+    if (divergedTick >= 0) {
+        printf("DIVERGED: state hash mismatch at tick %lld (last match at tick %lld)\n", divergedTick,
+               divergedTick - replay.hashInterval);
+        result = 2;
+    } else if (ticks < replay.tickCount) {
+        printf("DIVERGED: the game ended after %u of %u recorded ticks\n", ticks, replay.tickCount);
+        result = 2;
+    } else {
+        printf("OK: %u of %u hashes matched\n", hashesChecked, replay.hashCount);
+    }
+
+    FreeSimState(&sim);
+    FreeSimEventList(&events);
+    FreeReplay(&replay);
+    FreeSnapshotRing(&ring);
+    free(tickHashes);
+    return result;
+}
@@ -0,0 +1,39 @@
+#include "smash_rng.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+void SeedRng(Rng *rng, uint64_t seed, uint64_t stream) {
+    rng->state = 0;
+    rng->increment = (stream << 1) | 1u;
+    NextRandom(rng);
+    rng->state += seed;
+    NextRandom(rng);
+}
+
+// PCG-XSH-RR: advance the LCG, output a permuted 32-bit view of the old state
+uint32_t NextRandom(Rng *rng) {
+    uint64_t old = rng->state;
+    rng->state = old * PCG_MULTIPLIER + rng->increment;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rotation = (uint32_t)(old >> 59);
+    return (xorshifted >> rotation) | (xorshifted << ((32 - rotation) & 31));
+}
+
+// Multiply-shift range reduction (Lemire) with rejection, so every value is equally likely
+int RandomInt(Rng *rng, int bound) {
+    uint32_t range = (uint32_t)bound;
+    uint64_t product = (uint64_t)NextRandom(rng) * range;
+    uint32_t low = (uint32_t)product;
+    if (low < range) {
+        uint32_t threshold = (0u - range) % range;
+        while (low < threshold) {
+            product = (uint64_t)NextRandom(rng) * range;
+            low = (uint32_t)product;
+        }
+    }
+    return (int)(product >> 32);
+}
+
+float RandomFloat(Rng *rng) {
+    return (NextRandom(rng) >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,26 @@
+// Smash Out! random numbers
+//
+// PCG32 generator (O'Neill, pcg-random.org): 16 bytes of state, fast, and identical on
+// every platform and libc. One seed drives several independent streams, so gameplay
+// and cosmetic effects can draw numbers without perturbing each other.
+
+#ifndef SMASH_RNG_H
+#define SMASH_RNG_H
+
+#include <stdint.h>
+
+// Stream ids for the subsystems sharing a seed
+#define RNG_STREAM_GAMEPLAY 1  // Level layout, power-ups, ball spread (part of the simulation)
+#define RNG_STREAM_COSMETIC 2  // Particles, screen shake, menu background
+
+typedef struct Rng {
+    uint64_t state;
+    uint64_t increment;  // Selects the stream; always odd
+} Rng;
+
+void SeedRng(Rng *rng, uint64_t seed, uint64_t stream);
+uint32_t NextRandom(Rng *rng);
+int RandomInt(Rng *rng, int bound);  // Uniform in [0, bound), bound > 0
+float RandomFloat(Rng *rng);         // Uniform in [0, 1)
+
+#endif // SMASH_RNG_H
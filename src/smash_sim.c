@@ -0,0 +1,895 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "smash_sim.h"
+
+// Swept ball collision: what a moving ball ran into first during a tick
+typedef enum HitKind {
+    HIT_NONE,
+    HIT_WALL,
+    HIT_PADDLE,
+    HIT_BRICK
+} HitKind;
+
+typedef enum HitAxis {
+    HIT_AXIS_X,  // Vertical face (left/right side): reflect speed.x
+    HIT_AXIS_Y   // Horizontal face (top/bottom): reflect speed.y
+} HitAxis;
+
+typedef struct BallHit {
+    HitKind kind;
+    HitAxis axis;
+    float time;  // Fraction of the swept movement at which contact happens (0-1)
+    int brick;   // Brick index for HIT_BRICK
+} BallHit;
+
+#define MAX_BALL_CONTACTS 8  // Contacts resolved per ball per tick
+
+// Record an event for the presentation layer
+static void PushSimEvent(SimEventList *events, SimEventType type, SimVec2 position, int index) {
+    if (events->count >= events->capacity) {
+        int capacity = (events->capacity > 0) ? events->capacity * 2 : SIM_MIN_EVENTS;
+        SimEvent *grown = realloc(events->events, capacity * sizeof(SimEvent));
+        if (grown == NULL) {
+            events->dropped++;
+            return;
+        }
+        events->events = grown;
+        events->capacity = capacity;
+    }
+    SimEvent *event = &events->events[events->count++];
+    event->type = type;
+    event->position = position;
+    event->index = index;
+    event->combo = 0;
+    event->multiplier = 1.0f;
+}
+
+// The regular board: 10 columns, two rows more than the level number (capped)
+BoardLayout GetLevelLayout(int level) {
+    int rows = 2 + level;
+    if (rows > BOARD_MAX_ROWS) rows = BOARD_MAX_ROWS;
+    return (BoardLayout){
+        BOARD_COLS, rows,
+        (float)BRICK_LEFT_MARGIN, (float)BRICK_TOP_MARGIN,
+        (float)BRICK_PITCH_X, (float)BRICK_PITCH_Y,
+        (float)BRICK_WIDTH, (float)BRICK_HEIGHT
+    };
+}
+
+// Squeeze cols x rows bricks into the space the largest regular board covers,
+// keeping the default brick-to-gap proportions
+BoardLayout MakeFittedLayout(int cols, int rows) {
+    if (cols < 1) cols = 1;
+    if (rows < 1) rows = 1;
+    float pitchX = (float)(BOARD_COLS * BRICK_PITCH_X) / cols;
+    float pitchY = (float)(BOARD_MAX_ROWS * BRICK_PITCH_Y) / rows;
+    return (BoardLayout){
+        cols, rows,
+        (float)BRICK_LEFT_MARGIN, (float)BRICK_TOP_MARGIN,
+        pitchX, pitchY,
+        pitchX * BRICK_WIDTH / BRICK_PITCH_X,
+        pitchY * BRICK_HEIGHT / BRICK_PITCH_Y
+    };
+}
+
+// Switch the field to a new layout, growing the arrays if needed. Leaves it cleared.
+bool ResizeBrickField(BrickField *field, const BoardLayout *layout) {
+    int count = layout->cols * layout->rows;
+    if (count > field->capacity) {
+        int maskWords = (count + 31) / 32;
+        uint32_t *activeMask = realloc(field->activeMask, maskWords * sizeof(uint32_t));
+        if (activeMask != NULL) field->activeMask = activeMask;
+        uint32_t *discoveredMask = realloc(field->discoveredMask, maskWords * sizeof(uint32_t));
+        if (discoveredMask != NULL) field->discoveredMask = discoveredMask;
+        uint8_t *type = realloc(field->type, count);
+        if (type != NULL) field->type = type;
+        uint8_t *health = realloc(field->health, count);
+        if (health != NULL) field->health = health;
+        int *blastQueue = realloc(field->blastQueue, count * sizeof(int));
+        if (blastQueue != NULL) field->blastQueue = blastQueue;
+        uint32_t *wordStamp = realloc(field->wordStamp, maskWords * sizeof(uint32_t));
+        if (wordStamp != NULL) field->wordStamp = wordStamp;
+        if (activeMask == NULL || discoveredMask == NULL || type == NULL || health == NULL || blastQueue == NULL ||
+            wordStamp == NULL) return false;
+        field->capacity = count;
+    }
+    field->layout = *layout;
+    field->count = count;
+    ClearBrickField(field);
+    return true;
+}
+
+void FreeBrickField(BrickField *field) {
+    free(field->activeMask);
+    free(field->discoveredMask);
+    free(field->type);
+    free(field->health);
+    free(field->blastQueue);
+    free(field->wordStamp);
+    memset(field, 0, sizeof(*field));
+}
+
+// Deactivate every brick and reset the live-brick counter
+void ClearBrickField(BrickField *field) {
+    field->activeCount = 0;
+    field->blastHead = 0;
+    field->blastCount = 0;
+    field->stamp++;
+    if (field->count == 0) return;
+    int maskWords = (field->count + 31) / 32;
+    memset(field->activeMask, 0, maskWords * sizeof(uint32_t));
+    memset(field->discoveredMask, 0, maskWords * sizeof(uint32_t));
+    memset(field->type, 0, field->count);
+    memset(field->health, 0, field->count);
+    for (int w = 0; w < maskWords; w++) field->wordStamp[w] = field->stamp;
+}
+
+static void MarkBrickChanged(BrickField *field, int index) {
+    field->wordStamp[index >> 5] = field->stamp;
+}
+
+bool IsBrickActive(const BrickField *field, int index) {
+    return (field->activeMask[index >> 5] >> (index & 31)) & 1u;
+}
+
+bool IsBrickDiscovered(const BrickField *field, int index) {
+    return (field->discoveredMask[index >> 5] >> (index & 31)) & 1u;
+}
+
+void SetBrickDiscovered(BrickField *field, int index, bool discovered) {
+    uint32_t bit = 1u << (index & 31);
+    if (discovered) {
+        field->discoveredMask[index >> 5] |= bit;
+    } else {
+        field->discoveredMask[index >> 5] &= ~bit;
+    }
+    MarkBrickChanged(field, index);
+}
+
+void ActivateBrick(BrickField *field, int index) {
+    if (IsBrickActive(field, index)) return;
+    field->activeMask[index >> 5] |= 1u << (index & 31);
+    field->activeCount++;
+    MarkBrickChanged(field, index);
+}
+
+// Every brick removal goes through here so activeCount stays exact
+void DestroyBrick(BrickField *field, int index) {
+    if (!IsBrickActive(field, index)) return;
+    field->activeMask[index >> 5] &= ~(1u << (index & 31));
+    field->activeCount--;
+    MarkBrickChanged(field, index);
+}
+
+// Brick rectangles come straight from the grid layout
+SimRect GetBrickRect(const BrickField *field, int index) {
+    const BoardLayout *layout = &field->layout;
+    int row = index / layout->cols;
+    int col = index % layout->cols;
+    return (SimRect){
+        layout->left + col * layout->pitchX,
+        layout->top + row * layout->pitchY,
+        layout->brickWidth,
+        layout->brickHeight
+    };
+}
+
+static bool CheckCircleRec(SimVec2 center, float radius, SimRect rec) {
+    float closestX = fminf(fmaxf(center.x, rec.x), rec.x + rec.width);
+    float closestY = fminf(fmaxf(center.y, rec.y), rec.y + rec.height);
+    float dx = center.x - closestX;
+    float dy = center.y - closestY;
+    return (dx * dx + dy * dy) <= radius * radius;
+}
+
+static bool CheckRecs(SimRect a, SimRect b) {
+    return a.x < b.x + b.width && a.x + a.width > b.x &&
+           a.y < b.y + b.height && a.y + a.height > b.y;
+}
+
+static void SpawnPowerUp(SimState *sim, int x, int y) {
+    PowerUp *powerups = sim->powerups;
+    // Find first inactive power-up slot
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        if (!powerups[i].active) {
+            int randomType = RandomInt(&sim->rng, 4);
+            powerups[i].type = (PowerUpType)randomType;
+            powerups[i].rect = (SimRect){ (float)x, (float)y, 20, 20 };
+            powerups[i].active = true;
+            break;
+        }
+    }
+}
+
+// Append a ball to the packed array (dropped when the ball limit is reached)
+static void SpawnBall(SimState *sim, SimVec2 position, SimVec2 baseSpeed) {
+    if (sim->ballCount >= sim->ballLimit) return;
+    Ball *ball = &sim->balls[sim->ballCount++];
+    ball->position = position;
+    // Random horizontal velocity variation
+    float speedVariation = (RandomInt(&sim->rng, 100) - 50) / 100.0f * BALL_BASE_SPEED;
+    ball->speed = (SimVec2){ baseSpeed.x + speedVariation, baseSpeed.y };
+    ball->radius = BALL_RADIUS;
+}
+
+static void ResetPaddle(SimState *sim) {
+    sim->paddle = (SimRect){ SIM_SCREEN_WIDTH / 2 - PADDLE_WIDTH / 2, SIM_SCREEN_HEIGHT - 40, PADDLE_WIDTH, PADDLE_HEIGHT };
+    sim->paddleBuffTimer = 0.0f;
+}
+
+// The config and the brick/ball storage carry over into the new game
+bool StartGame(SimState *sim) {
+    SimConfig config = sim->config;
+    BrickField bricks = sim->bricks;
+    Ball *balls = sim->balls;
+    int ballLimit = sim->ballLimit;
+    memset(sim, 0, sizeof(*sim));
+    sim->config = config;
+    sim->bricks = bricks;
+    sim->balls = balls;
+    sim->ballLimit = ballLimit;
+
+    int limit = config.massiveMultiball ? MASSIVE_MAX_BALLS : MAX_BALLS;
+    if (sim->balls == NULL || sim->ballLimit != limit) {
+        balls = realloc(sim->balls, limit * sizeof(Ball));
+        if (balls == NULL) return false;
+        sim->balls = balls;
+        sim->ballLimit = limit;
+    }
+
+    SeedRng(&sim->rng, config.seed, RNG_STREAM_GAMEPLAY);
+    sim->lives = START_LIVES;
+    return LoadLevel(sim, 1);
+}
+
+void FreeSimState(SimState *sim) {
+    FreeBrickField(&sim->bricks);
+    free(sim->balls);
+    sim->balls = NULL;
+    sim->ballCount = 0;
+    sim->ballLimit = 0;
+}
+
+// Load level with procedural layout
+bool LoadLevel(SimState *sim, int level) {
+    BrickField *bricks = &sim->bricks;
+    BoardLayout layout = (sim->config.customBoard.cols > 0) ? sim->config.customBoard : GetLevelLayout(level);
+
+    sim->status = SIM_RUNNING;
+    sim->level = level;
+    sim->levelTimer = 0.0f;
+    sim->levelCompletionTime = 0.0f;
+    sim->timeBonus = 0;
+    sim->brickCombo = 0;
+    sim->comboMultiplier = 1.0f;
+
+    // Reset brick counter
+    sim->bricksSmashed = 0;
+
+    // Size the board for this level (this also deactivates all bricks)
+    bool allocated = ResizeBrickField(bricks, &layout);
+    if (!allocated) ResizeBrickField(bricks, &(BoardLayout){ 0 });
+
+    // Create pattern based on level
+    for (int i = 0; i < bricks->count; i++) {
+        int row = i / layout.cols;
+        int col = i % layout.cols;
+
+        // Apply pattern based on level
+        bool active;
+        if (level % 2 == 0) {
+            // Checkerboard pattern for even levels
+            active = ((row + col) % 2 == 0);
+        } else if (level % 3 == 0) {
+            // V-Shape/Pyramid pattern for levels divisible by 3
+            int distFromCenter = col - (layout.cols / 2);
+            active = (row >= abs(distFromCenter) - 1);
+        } else {
+            // Default: fill all bricks
+            active = true;
+        }
+
+        // Assign brick types randomly (only for active bricks)
+        if (active) {
+            ActivateBrick(bricks, i);
+            SetBrickDiscovered(bricks, i, true);
+
+            int typeRoll = RandomInt(&sim->rng, 100);
+            if (typeRoll < 60) {
+                // 60% Normal
+                bricks->type[i] = BRICK_NORMAL;
+                bricks->health[i] = 1;
+            } else if (typeRoll < 75) {
+                // 15% Tough (increases with level)
+                bricks->type[i] = BRICK_TOUGH;
+                bricks->health[i] = (level >= 3) ? 3 : (level == 2 ? 2 : 1);
+            } else if (typeRoll < 85) {
+                // 10% Explosive
+                bricks->type[i] = BRICK_EXPLOSIVE;
+                bricks->health[i] = 1;
+            } else if (typeRoll < 92) {
+                // 7% Speed
+                bricks->type[i] = BRICK_SPEED;
+                bricks->health[i] = 1;
+            } else {
+                // 8% Invisible (increases with level)
+                bricks->type[i] = BRICK_INVISIBLE;
+                bricks->health[i] = 1;
+                SetBrickDiscovered(bricks, i, level == 1);
+            }
+        }
+    }
+
+    // Reset balls with increased speed per level
+    SimVec2 launchPosition = { 400, 500 };
+    SimVec2 launchSpeed = { BALL_BASE_SPEED, -(BALL_BASE_SPEED + (level - 1) * BALL_LEVEL_SPEEDUP) };  // Increase speed per level
+    sim->ballCount = 1;
+    sim->balls[0] = (Ball){ launchPosition, launchSpeed, BALL_RADIUS };
+    for (int i = 1; i < sim->config.startBalls; i++) {
+        SpawnBall(sim, launchPosition, launchSpeed);
+    }
+
+    // Clear power-ups and buffs for the new level
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        sim->powerups[i].active = false;
+    }
+    ResetPaddle(sim);
+    return allocated;
+}
+
+// Sweep a circle moving by delta against a rectangle. The rectangle is expanded by the
+// radius (square corners), which turns the test into a ray-vs-box slab test.
+// Returns true if the circle enters the rectangle within this movement.
+static bool SweepCircleRec(SimVec2 center, float radius, SimVec2 delta, SimRect rec, float *time, HitAxis *axis) {
+    float minX = rec.x - radius;
+    float maxX = rec.x + rec.width + radius;
+    float minY = rec.y - radius;
+    float maxY = rec.y + rec.height + radius;
+
+    float enterX, exitX, enterY, exitY;
+    if (delta.x != 0.0f) {
+        float t1 = (minX - center.x) / delta.x;
+        float t2 = (maxX - center.x) / delta.x;
+        enterX = fminf(t1, t2);
+        exitX = fmaxf(t1, t2);
+    } else {
+        if (center.x <= minX || center.x >= maxX) return false;
+        enterX = -INFINITY;
+        exitX = INFINITY;
+    }
+    if (delta.y != 0.0f) {
+        float t1 = (minY - center.y) / delta.y;
+        float t2 = (maxY - center.y) / delta.y;
+        enterY = fminf(t1, t2);
+        exitY = fmaxf(t1, t2);
+    } else {
+        if (center.y <= minY || center.y >= maxY) return false;
+        enterY = -INFINITY;
+        exitY = INFINITY;
+    }
+
+    float enter = fmaxf(enterX, enterY);
+    float exit = fminf(exitX, exitY);
+
+    // Starting inside (enter < 0) or grazing an edge doesn't count as a new contact
+    if (enter >= exit || enter < 0.0f || enter > 1.0f) return false;
+
+    *time = enter;
+    *axis = (enterX > enterY) ? HIT_AXIS_X : HIT_AXIS_Y;
+    return true;
+}
+
+// Map a screen-space box to the range of brick grid cells it overlaps.
+// Returns false if the box misses the brick grid entirely.
+static bool GetBrickCellRange(const BoardLayout *layout, SimRect bounds, int *colMin, int *colMax, int *rowMin, int *rowMax) {
+    if (layout->cols == 0 || layout->rows == 0) return false;
+
+    // Clamp in float first so huge or far-off boxes can't overflow the int conversion
+    float firstCol = floorf((bounds.x - layout->left) / layout->pitchX);
+    float lastCol = floorf((bounds.x + bounds.width - layout->left) / layout->pitchX);
+    float firstRow = floorf((bounds.y - layout->top) / layout->pitchY);
+    float lastRow = floorf((bounds.y + bounds.height - layout->top) / layout->pitchY);
+    if (lastCol < 0.0f || firstCol >= layout->cols || lastRow < 0.0f || firstRow >= layout->rows) return false;
+
+    *colMin = (int)fmaxf(firstCol, 0.0f);
+    *colMax = (int)fminf(lastCol, layout->cols - 1.0f);
+    *rowMin = (int)fmaxf(firstRow, 0.0f);
+    *rowMax = (int)fminf(lastRow, layout->rows - 1.0f);
+    return true;
+}
+
+// Box covering a ball over its whole movement by delta
+static SimRect GetSweptBounds(SimVec2 position, float radius, SimVec2 delta) {
+    return (SimRect){
+        fminf(position.x, position.x + delta.x) - radius,
+        fminf(position.y, position.y + delta.y) - radius,
+        fabsf(delta.x) + radius * 2.0f,
+        fabsf(delta.y) + radius * 2.0f
+    };
+}
+
+// Box around every brick slot of a layout
+static SimRect GetBoardBounds(const BoardLayout *layout) {
+    if (layout->cols == 0 || layout->rows == 0) return (SimRect){ 0 };
+    return (SimRect){
+        layout->left,
+        layout->top,
+        (layout->cols - 1) * layout->pitchX + layout->brickWidth,
+        (layout->rows - 1) * layout->pitchY + layout->brickHeight
+    };
+}
+
+// Broad phase: a ball whose swept box stays inside the side and top walls and clear
+// of the paddle and the brick board can't hit anything this tick, so it skips the
+// contact solver and just moves
+static bool IsBallPathClear(SimRect swept, SimRect paddle, SimRect board) {
+    return swept.x > 0.0f && swept.x + swept.width < SIM_SCREEN_WIDTH && swept.y > 0.0f &&
+           !CheckRecs(swept, paddle) && !CheckRecs(swept, board);
+}
+
+// Find the earliest contact of a ball moving by delta against the walls, paddle and bricks
+static BallHit FindFirstBallHit(SimVec2 position, float radius, SimVec2 delta, SimRect paddle, const BrickField *bricks) {
+    BallHit hit = { HIT_NONE, HIT_AXIS_Y, 1.0f, -1 };
+    float t;
+    HitAxis axis;
+
+    // Walls (only when moving toward them; a ball already past a wall reflects immediately)
+    if (delta.x < 0.0f) {
+        t = fmaxf((radius - position.x) / delta.x, 0.0f);
+        if (t <= hit.time) hit = (BallHit){ HIT_WALL, HIT_AXIS_X, t, -1 };
+    } else if (delta.x > 0.0f) {
+        t = fmaxf((SIM_SCREEN_WIDTH - radius - position.x) / delta.x, 0.0f);
+        if (t <= hit.time) hit = (BallHit){ HIT_WALL, HIT_AXIS_X, t, -1 };
+    }
+    if (delta.y < 0.0f) {
+        t = fmaxf((radius - position.y) / delta.y, 0.0f);
+        if (t < hit.time) hit = (BallHit){ HIT_WALL, HIT_AXIS_Y, t, -1 };
+    }
+
+    // Paddle. It moves before the balls, so it can end up overlapping a falling ball;
+    // treat that as an immediate top hit, as the old discrete check did.
+    if (SweepCircleRec(position, radius, delta, paddle, &t, &axis)) {
+        if (t < hit.time) hit = (BallHit){ HIT_PADDLE, axis, t, -1 };
+    } else if (delta.y > 0.0f && CheckCircleRec(position, radius, paddle)) {
+        hit = (BallHit){ HIT_PADDLE, HIT_AXIS_Y, 0.0f, -1 };
+    }
+
+    // Bricks: only the grid cells under the swept bounds can be hit
+    SimRect swept = GetSweptBounds(position, radius, delta);
+    int colMin, colMax, rowMin, rowMax;
+    if (GetBrickCellRange(&bricks->layout, swept, &colMin, &colMax, &rowMin, &rowMax)) {
+        for (int row = rowMin; row <= rowMax; row++) {
+            for (int col = colMin; col <= colMax; col++) {
+                int i = row * bricks->layout.cols + col;
+                if (!IsBrickActive(bricks, i)) continue;
+                if (SweepCircleRec(position, radius, delta, GetBrickRect(bricks, i), &t, &axis) && t < hit.time) {
+                    hit = (BallHit){ HIT_BRICK, axis, t, i };
+                }
+            }
+        }
+    }
+
+    return hit;
+}
+
+// 20% chance to drop a power-up from a destroyed brick
+static void RollPowerUp(SimState *sim, SimRect brickRect) {
+    if (RandomInt(&sim->rng, 100) < POWERUP_SPAWN_CHANCE) {
+        SpawnPowerUp(sim, (int)(brickRect.x + brickRect.width / 2), (int)brickRect.y);
+    }
+}
+
+// Queue an explosive brick's blast; ResolveChainReactions sets it off
+static void QueueBlast(BrickField *bricks, int i) {
+    int tail = (bricks->blastHead + bricks->blastCount) % bricks->count;
+    bricks->blastQueue[tail] = i;
+    bricks->blastCount++;
+}
+
+// A brick caught in a blast is destroyed outright and gets the same accounting as a
+// direct hit: smash count, score, event and power-up roll. Explosive ones join the chain.
+static void ExplodeBrick(SimState *sim, int i, SimEventList *events) {
+    BrickField *bricks = &sim->bricks;
+    SimRect brickRect = GetBrickRect(bricks, i);
+    SimVec2 brickCenter = { brickRect.x + brickRect.width / 2, brickRect.y + brickRect.height / 2 };
+
+    DestroyBrick(bricks, i);
+    sim->bricksSmashed++;
+    sim->score += (int)(10 * sim->comboMultiplier);
+    PushSimEvent(events, SIM_EVENT_BRICK_EXPLODED, brickCenter, i);
+    RollPowerUp(sim, brickRect);
+
+    if (bricks->type[i] == BRICK_EXPLOSIVE) QueueBlast(bricks, i);
+}
+
+// Set off queued blasts in order, at most chainBudget per tick. Each blast destroys
+// every live brick within blastRadius grid steps (diamond shape) of the exploded brick.
+static void ResolveChainReactions(SimState *sim, SimEventList *events) {
+    BrickField *bricks = &sim->bricks;
+    int cols = bricks->layout.cols;
+    int rows = bricks->layout.rows;
+    int radius = (sim->config.blastRadius > 0) ? sim->config.blastRadius : BLAST_RADIUS;
+    int budget = (sim->config.chainBudget > 0) ? sim->config.chainBudget : CHAIN_BLASTS_PER_TICK;
+
+    for (; budget > 0 && bricks->blastCount > 0; budget--) {
+        int center = bricks->blastQueue[bricks->blastHead];
+        bricks->blastHead = (bricks->blastHead + 1) % bricks->count;
+        bricks->blastCount--;
+
+        int centerRow = center / cols;
+        int centerCol = center % cols;
+        for (int dr = -radius; dr <= radius; dr++) {
+            int row = centerRow + dr;
+            if (row < 0 || row >= rows) continue;
+            int reach = radius - abs(dr);
+            for (int dc = -reach; dc <= reach; dc++) {
+                int col = centerCol + dc;
+                if (col < 0 || col >= cols) continue;
+                int i = row * cols + col;
+                if (IsBrickActive(bricks, i)) ExplodeBrick(sim, i, events);
+            }
+        }
+    }
+}
+
+// Apply a ball hitting brick i: combo, brick type effects, score and power-up drop
+static void HitBrick(SimState *sim, Ball *ball, int i, SimEventList *events) {
+    BrickField *bricks = &sim->bricks;
+    SimRect brickRect = GetBrickRect(bricks, i);
+    SimVec2 brickCenter = { brickRect.x + brickRect.width / 2, brickRect.y + brickRect.height / 2 };
+
+    // Update combo
+    sim->brickCombo++;
+    sim->comboMultiplier = 1.0f + (sim->brickCombo - 1) * 0.5f;  // 1.0x, 1.5x, 2.0x, etc.
+    if (sim->comboMultiplier > 3.0f) sim->comboMultiplier = 3.0f;  // Cap at 3x
+
+    int eventIndex = events->count;
+    PushSimEvent(events, SIM_EVENT_BRICK_HIT, brickCenter, i);
+    if (eventIndex < events->count) {
+        events->events[eventIndex].combo = sim->brickCombo;
+        events->events[eventIndex].multiplier = sim->comboMultiplier;
+    }
+
+    int scoreGain = 10;
+
+    // Handle brick types
+    switch (bricks->type[i]) {
+        case BRICK_NORMAL:
+            DestroyBrick(bricks, i);
+            sim->bricksSmashed++;
+            break;
+
+        case BRICK_TOUGH:
+            bricks->health[i]--;
+            MarkBrickChanged(bricks, i);
+            if (bricks->health[i] == 0) {
+                DestroyBrick(bricks, i);
+                sim->bricksSmashed++;
+                scoreGain = 30;  // More points for tough bricks
+            } else {
+                scoreGain = 5;  // Partial points for damage
+            }
+            break;
+
+        case BRICK_EXPLOSIVE:
+            DestroyBrick(bricks, i);
+            sim->bricksSmashed++;
+            QueueBlast(bricks, i);  // Neighbours score as the blast reaches them
+            scoreGain = 20;
+            break;
+
+        case BRICK_SPEED:
+            DestroyBrick(bricks, i);
+            sim->bricksSmashed++;
+            // Increase ball speed permanently for this level
+            ball->speed.x *= 1.2f;
+            ball->speed.y *= 1.2f;
+            scoreGain = 25;
+            break;
+
+        case BRICK_INVISIBLE:
+            SetBrickDiscovered(bricks, i, true);  // Reveal it
+            if (IsBrickDiscovered(bricks, i)) {
+                DestroyBrick(bricks, i);  // Actually destroy it next hit
+                sim->bricksSmashed++;
+                scoreGain = 15;  // Points for discovery and destruction
+            } else {
+                scoreGain = 5;  // Points for discovery
+            }
+            break;
+
+        default:
+            DestroyBrick(bricks, i);
+            sim->bricksSmashed++;
+    }
+
+    // Apply combo multiplier to score
+    sim->score += (int)(scoreGain * sim->comboMultiplier);
+
+    // 20% chance to spawn power-up (except from tough with health > 0)
+    RollPowerUp(sim, brickRect);
+}
+
+// Sweep a ball along its path for one tick and resolve contacts in time-of-impact order
+static void UpdateBall(SimState *sim, Ball *ball, SimEventList *events) {
+    float remaining = 1.0f;  // Fraction of this tick's movement left to travel
+    for (int contact = 0; contact < MAX_BALL_CONTACTS && remaining > 0.0f; contact++) {
+        SimVec2 delta = { ball->speed.x * SIM_DT * remaining, ball->speed.y * SIM_DT * remaining };
+        BallHit hit = FindFirstBallHit(ball->position, ball->radius, delta, sim->paddle, &sim->bricks);
+
+        if (hit.kind == HIT_NONE) {
+            ball->position.x += delta.x;
+            ball->position.y += delta.y;
+            break;
+        }
+
+        // Advance to the contact point and reflect off the face that was hit
+        ball->position.x += delta.x * hit.time;
+        ball->position.y += delta.y * hit.time;
+        remaining *= 1.0f - hit.time;
+        if (hit.axis == HIT_AXIS_X) {
+            ball->speed.x *= -1.0f;
+        } else {
+            ball->speed.y *= -1.0f;
+        }
+
+        if (hit.kind == HIT_WALL) {
+            PushSimEvent(events, SIM_EVENT_WALL_HIT, ball->position, -1);
+        } else if (hit.kind == HIT_PADDLE) {
+            // Add horizontal velocity based on where ball hits the top of the paddle
+            if (hit.axis == HIT_AXIS_Y) {
+                ball->position.y = sim->paddle.y - ball->radius;
+                float hitPos = (ball->position.x - sim->paddle.x) / sim->paddle.width;
+                ball->speed.x = (hitPos - 0.5f) * 2.0f * BALL_BASE_SPEED;
+            }
+            PushSimEvent(events, SIM_EVENT_PADDLE_HIT, ball->position, -1);
+
+            // Reset combo when ball touches paddle
+            sim->brickCombo = 0;
+            sim->comboMultiplier = 1.0f;
+        } else if (hit.kind == HIT_BRICK) {
+            HitBrick(sim, ball, hit.brick, events);
+        }
+    }
+}
+
+void StepSimulation(SimState *sim, SimInput input, SimEventList *events) {
+    events->count = 0;
+    events->dropped = 0;
+    if (sim->status != SIM_RUNNING) return;
+
+    sim->tick++;
+    sim->bricks.stamp++;
+
+    // Update level timer
+    sim->levelTimer += SIM_DT;
+
+    // Update paddle buff timer
+    if (sim->paddleBuffTimer > 0.0f) {
+        sim->paddleBuffTimer -= SIM_DT;
+        if (sim->paddleBuffTimer <= 0.0f) {
+            sim->paddle.width = PADDLE_WIDTH;
+            sim->paddleBuffTimer = 0.0f;
+        }
+    }
+
+    // Move Paddle
+    if ((input.buttons & SIM_INPUT_LEFT) && sim->paddle.x > 0) sim->paddle.x -= PADDLE_SPEED * SIM_DT;
+    if ((input.buttons & SIM_INPUT_RIGHT) && sim->paddle.x < SIM_SCREEN_WIDTH - sim->paddle.width) sim->paddle.x += PADDLE_SPEED * SIM_DT;
+
+    // Update balls. Balls with nothing in reach move straight; the rest go through the
+    // swept contact solver. A ball that falls off screen is replaced by the last one.
+    SimRect board = GetBoardBounds(&sim->bricks.layout);
+    SimVec2 lostPosition = { 0 };
+    for (int b = 0; b < sim->ballCount;) {
+        Ball *ball = &sim->balls[b];
+        SimVec2 delta = { ball->speed.x * SIM_DT, ball->speed.y * SIM_DT };
+        if (IsBallPathClear(GetSweptBounds(ball->position, ball->radius, delta), sim->paddle, board)) {
+            ball->position.x += delta.x;
+            ball->position.y += delta.y;
+        } else {
+            UpdateBall(sim, ball, events);
+        }
+
+        // Ball falls off screen
+        if (ball->position.y > SIM_SCREEN_HEIGHT) {
+            PushSimEvent(events, SIM_EVENT_BALL_LOST, ball->position, -1);
+            lostPosition = ball->position;
+            *ball = sim->balls[--sim->ballCount];
+            continue;  // Update the ball that moved into this slot
+        }
+        b++;
+    }
+
+    // Check if all balls are gone
+    if (sim->ballCount == 0) {
+        sim->lives--;
+        if (sim->lives <= 0) {
+            sim->status = SIM_GAME_OVER;
+            PushSimEvent(events, SIM_EVENT_GAME_OVER, lostPosition, -1);
+            return;
+        }
+        PushSimEvent(events, SIM_EVENT_LIFE_LOST, lostPosition, -1);
+        sim->ballCount = 1;
+        sim->balls[0] = (Ball){ { SIM_SCREEN_WIDTH / 2, SIM_SCREEN_HEIGHT / 2 }, { BALL_BASE_SPEED, -BALL_BASE_SPEED }, BALL_RADIUS };
+    }
+
+    // Update power-ups
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        PowerUp *powerup = &sim->powerups[i];
+        if (!powerup->active) continue;
+
+        // Fall downward
+        powerup->rect.y += POWERUP_SPEED * SIM_DT;
+
+        // Check collision with paddle
+        if (CheckRecs(powerup->rect, sim->paddle)) {
+            powerup->active = false;
+
+            // Apply power-up effect
+            if (powerup->type == MULTIBALL) {
+                if (sim->config.massiveMultiball) {
+                    // Every ball in play splits in two
+                    int count = sim->ballCount;
+                    for (int b = 0; b < count; b++) {
+                        SpawnBall(sim, sim->balls[b].position, sim->balls[b].speed);
+                    }
+                } else {
+                    // Spawn a second ball
+                    SpawnBall(sim, sim->balls[0].position, sim->balls[0].speed);
+                }
+            } else if (powerup->type == WIDE_PADDLE) {
+                sim->paddle.width = PADDLE_WIDTH * 2.0f;
+                sim->paddleBuffTimer = 10.0f;
+            } else if (powerup->type == SCREEN_WIDE) {
+                sim->paddle.width = SIM_SCREEN_WIDTH;
+                sim->paddle.x = 0;
+                sim->paddleBuffTimer = 5.0f;
+            } else if (powerup->type == EXTRA_LIFE) {
+                if (sim->lives < MAX_LIVES) sim->lives++;
+            }
+            PushSimEvent(events, SIM_EVENT_POWERUP_COLLECTED, (SimVec2){ powerup->rect.x, powerup->rect.y }, powerup->type);
+        } else if (powerup->rect.y > SIM_SCREEN_HEIGHT) {
+            // Power-up fell off screen
+            powerup->active = false;
+        }
+    }
+
+    // Explosive chains carry on from earlier ticks
+    ResolveChainReactions(sim, events);
+
+    // Check win condition
+    if (sim->bricks.activeCount == 0) {
+        // All bricks destroyed - award the time bonus once
+        sim->levelCompletionTime = sim->levelTimer;
+        sim->timeBonus = 0;
+        if (sim->levelCompletionTime < TIME_LIMIT) {
+            sim->timeBonus = (int)(MAX_TIME_BONUS * (1.0f - sim->levelCompletionTime / TIME_LIMIT));
+        }
+        sim->score += sim->timeBonus;
+        sim->status = SIM_LEVEL_CLEARED;
+        PushSimEvent(events, SIM_EVENT_LEVEL_CLEARED, (SimVec2){ 0, 0 }, sim->level);
+    }
+}
+
+void FreeSimEventList(SimEventList *events) {
+    free(events->events);
+    *events = (SimEventList){ 0 };
+}
+
+#define PREDICT_MAX_STEPS 96  // Trace segments per prediction
+
+// March the ball along its path with the same contact query the solver uses. Near the
+// board each segment is at most one brick pitch long, so a query only looks at a few
+// grid cells; in open space a segment runs straight to the next wall or the paddle line.
+bool PredictBallLanding(const SimState *sim, const Ball *ball, float maxTime, BallLanding *landing) {
+    const BoardLayout *layout = &sim->bricks.layout;
+    SimRect board = GetBoardBounds(layout);
+    SimRect noPaddle = { -1000.0f, -1000.0f, 0.0f, 0.0f };  // The paddle line ends the trace instead
+    float lineY = sim->paddle.y - ball->radius;
+    float pitch = fminf(layout->pitchX, layout->pitchY);
+
+    SimVec2 position = ball->position;
+    SimVec2 speed = ball->speed;
+    float time = 0.0f;
+    int bounces = 0;
+    for (int step = 0; step < PREDICT_MAX_STEPS && time < maxTime; step++) {
+        if (speed.y > 0.0f && position.y >= lineY) break;
+
+        float duration = maxTime - time;
+        bool toLine = false;
+        if (speed.y > 0.0f && (lineY - position.y) / speed.y <= duration) {
+            duration = (lineY - position.y) / speed.y;
+            toLine = true;
+        }
+        SimVec2 delta = { speed.x * duration, speed.y * duration };
+        float fastest = fmaxf(fabsf(speed.x), fabsf(speed.y));
+        if (pitch > 0.0f && fastest > 0.0f && CheckRecs(GetSweptBounds(position, ball->radius, delta), board) &&
+            duration * fastest > pitch) {
+            duration = pitch / fastest;
+            delta = (SimVec2){ speed.x * duration, speed.y * duration };
+            toLine = false;
+        }
+
+        BallHit hit = FindFirstBallHit(position, ball->radius, delta, noPaddle, &sim->bricks);
+        position.x += delta.x * hit.time;
+        position.y += delta.y * hit.time;
+        time += duration * hit.time;
+        if (hit.kind == HIT_NONE) {
+            if (toLine) {
+                position.y = lineY;
+                break;
+            }
+            continue;
+        }
+        if (hit.axis == HIT_AXIS_X) {
+            speed.x *= -1.0f;
+        } else {
+            speed.y *= -1.0f;
+        }
+        bounces++;
+    }
+
+    if (speed.y <= 0.0f || position.y < lineY) return false;
+    landing->x = position.x;
+    landing->time = time;
+    landing->bounces = bounces;
+    return true;
+}
+
+// FNV-1a over a run of bytes
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size) {
+    const uint8_t *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+#define HASH_FIELD(hash, field) HashBytes((hash), &(field), sizeof(field))
+
+// Field by field so struct padding and spare heap capacity never reach the hash
+uint64_t HashSimState(const SimState *sim) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = HASH_FIELD(hash, sim->status);
+    hash = HASH_FIELD(hash, sim->level);
+    hash = HASH_FIELD(hash, sim->score);
+    hash = HASH_FIELD(hash, sim->lives);
+    hash = HASH_FIELD(hash, sim->tick);
+    hash = HASH_FIELD(hash, sim->rng.state);
+    hash = HASH_FIELD(hash, sim->paddle);
+    hash = HASH_FIELD(hash, sim->paddleBuffTimer);
+
+    hash = HASH_FIELD(hash, sim->ballCount);
+    for (int i = 0; i < sim->ballCount; i++) {
+        hash = HASH_FIELD(hash, sim->balls[i].position);
+        hash = HASH_FIELD(hash, sim->balls[i].speed);
+        hash = HASH_FIELD(hash, sim->balls[i].radius);
+    }
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        if (!sim->powerups[i].active) continue;
+        hash = HASH_FIELD(hash, i);
+        hash = HASH_FIELD(hash, sim->powerups[i].type);
+        hash = HASH_FIELD(hash, sim->powerups[i].rect);
+    }
+
+    const BrickField *bricks = &sim->bricks;
+    size_t maskBytes = (size_t)(bricks->count + 31) / 32 * sizeof(uint32_t);
+    hash = HASH_FIELD(hash, bricks->count);
+    hash = HashBytes(hash, bricks->activeMask, maskBytes);
+    hash = HashBytes(hash, bricks->discoveredMask, maskBytes);
+    hash = HashBytes(hash, bricks->type, (size_t)bricks->count);
+    hash = HashBytes(hash, bricks->health, (size_t)bricks->count);
+    hash = HASH_FIELD(hash, bricks->activeCount);
+    for (int i = 0; i < bricks->blastCount; i++) {
+        hash = HASH_FIELD(hash, bricks->blastQueue[(bricks->blastHead + i) % bricks->count]);
+    }
+
+    hash = HASH_FIELD(hash, sim->brickCombo);
+    hash = HASH_FIELD(hash, sim->comboMultiplier);
+    hash = HASH_FIELD(hash, sim->levelTimer);
+    hash = HASH_FIELD(hash, sim->bricksSmashed);
+    return hash;
+}
@@ -0,0 +1,256 @@
+// Smash Out! gameplay simulation: fixed-tick game logic with no raylib dependency,
+// fed one SimInput per tick and reporting what happened as a SimEventList.
+
+#ifndef SMASH_SIM_H
+#define SMASH_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "smash_rng.h"
+
+// Playfield size (pixels)
+#define SIM_SCREEN_WIDTH 800
+#define SIM_SCREEN_HEIGHT 600
+
+#define MAX_BALLS 5
+#define MASSIVE_MAX_BALLS 8192  // Ball limit in massive-multiball mode
+#define MAX_POWERUPS 50
+#define POWERUP_SPAWN_CHANCE 20  // 20% chance to spawn on brick break
+#define POWERUP_SPEED 180.0f  // Pixels per second
+
+// Explosive brick chain reactions
+#define BLAST_RADIUS 1            // Bricks within this many grid steps (up/down + left/right) are destroyed
+#define CHAIN_BLASTS_PER_TICK 8   // Queued blasts resolved per tick; bigger cascades spread over several ticks
+
+// Default brick grid layout (pixels). Bricks sit on a regular grid, which the collision
+// code uses to map a region of the screen straight to the bricks it can touch. The
+// actual dimensions come from the BoardLayout chosen when a level loads.
+#define BOARD_COLS 10
+#define BOARD_MAX_ROWS 8  // Rows grow with the level up to this
+#define BRICK_WIDTH 70
+#define BRICK_HEIGHT 20
+#define BRICK_PADDING 10
+#define BRICK_PITCH_X (BRICK_WIDTH + BRICK_PADDING)
+#define BRICK_PITCH_Y (BRICK_HEIGHT + BRICK_PADDING)
+#define BRICK_LEFT_MARGIN 40
+#define BRICK_TOP_MARGIN 120  // Leaves room for the HUD bar (y: 0-80)
+
+// Fixed-timestep simulation: gameplay always advances in SIM_DT steps,
+// independent of the rendered frame rate. All velocities are in pixels per second.
+#define SIM_TICK_RATE 120
+#define SIM_DT (1.0f / SIM_TICK_RATE)
+#define BALL_BASE_SPEED 240.0f
+#define BALL_LEVEL_SPEEDUP 30.0f  // Extra vertical speed per level
+#define BALL_RADIUS 8.0f
+#define PADDLE_SPEED 480.0f
+#define PADDLE_WIDTH 100.0f
+#define PADDLE_HEIGHT 20.0f
+
+#define START_LIVES 3
+#define MAX_LIVES 5
+
+// Time bonus
+#define TIME_LIMIT 60.0f  // 60 seconds to get time bonus
+#define MAX_TIME_BONUS 500  // Maximum bonus points
+
+typedef struct SimVec2 {
+    float x;
+    float y;
+} SimVec2;
+
+typedef struct SimRect {
+    float x;
+    float y;
+    float width;
+    float height;
+} SimRect;
+
+typedef enum PowerUpType {
+    MULTIBALL,
+    WIDE_PADDLE,
+    SCREEN_WIDE,
+    EXTRA_LIFE
+} PowerUpType;
+
+typedef enum BrickType {
+    BRICK_NORMAL,
+    BRICK_TOUGH,
+    BRICK_EXPLOSIVE,
+    BRICK_SPEED,
+    BRICK_INVISIBLE
+} BrickType;
+
+typedef struct PowerUp {
+    SimRect rect;
+    PowerUpType type;
+    bool active;
+} PowerUp;
+
+// Board dimensions and brick placement, picked per level
+typedef struct BoardLayout {
+    int cols;
+    int rows;
+    float left;         // Screen position of the top-left brick
+    float top;
+    float pitchX;       // Distance between neighbouring bricks
+    float pitchY;
+    float brickWidth;
+    float brickHeight;
+} BoardLayout;
+
+// Brick field stored as structure-of-arrays: one bit per brick for the active and
+// discovered flags and one byte each for type and health, indexed row * cols + col.
+// Rectangles are not stored, they are derived from the layout (GetBrickRect).
+// activeCount is updated by every activate/destroy, so the win check and HUD never
+// rescan the field. The arrays live on the heap and only grow (ResizeBrickField).
+typedef struct BrickField {
+    BoardLayout layout;
+    int count;     // cols * rows
+    int capacity;  // Bricks the arrays can hold
+    uint32_t *activeMask;
+    uint32_t *discoveredMask;  // For INVISIBLE bricks: set = revealed
+    uint8_t *type;    // BrickType
+    uint8_t *health;  // For TOUGH bricks: 1-3 hits
+    int activeCount;
+
+    // Explosive bricks destroyed but not yet blasted, as a ring buffer. A brick is
+    // queued only when it is destroyed, so capacity entries always fit.
+    int *blastQueue;
+    int blastHead;
+    int blastCount;
+
+    // Change tracking for snapshot deltas: stamp goes up every tick and every clear, and
+    // wordStamp[w] is its value when a brick in 32w..32w+31 last changed
+    uint32_t *wordStamp;
+    uint32_t stamp;
+} BrickField;
+
+// Balls in play are packed in balls[0, ballCount); a lost ball is swap-removed
+typedef struct Ball {
+    SimVec2 position;
+    SimVec2 speed;
+    float radius;
+} Ball;
+
+// Player input for one tick
+#define SIM_INPUT_LEFT  0x01
+#define SIM_INPUT_RIGHT 0x02
+
+typedef struct SimInput {
+    uint8_t buttons;  // SIM_INPUT_* bits held during the tick
+} SimInput;
+
+// Things that happened during a tick, for the presentation layer
+typedef enum SimEventType {
+    SIM_EVENT_WALL_HIT,
+    SIM_EVENT_PADDLE_HIT,
+    SIM_EVENT_BRICK_HIT,          // position: brick centre, index: brick, combo/multiplier after the hit
+    SIM_EVENT_BRICK_EXPLODED,     // position: brick centre, index: brick destroyed by a blast
+    SIM_EVENT_BALL_LOST,          // position: where the ball left the screen
+    SIM_EVENT_LIFE_LOST,
+    SIM_EVENT_POWERUP_COLLECTED,  // index: PowerUpType
+    SIM_EVENT_LEVEL_CLEARED,
+    SIM_EVENT_GAME_OVER
+} SimEventType;
+
+typedef struct SimEvent {
+    SimEventType type;
+    SimVec2 position;
+    int index;
+    int combo;
+    float multiplier;
+} SimEvent;
+
+#define SIM_MIN_EVENTS 256  // First allocation; the list doubles when a tick needs more
+
+// Grows to the busiest tick seen, so massive multiball keeps every event.
+// Start zeroed and release with FreeSimEventList.
+typedef struct SimEventList {
+    SimEvent *events;
+    int count;
+    int capacity;
+    int dropped;  // Events lost this tick because the list couldn't grow
+} SimEventList;
+
+typedef enum SimStatus {
+    SIM_RUNNING,
+    SIM_LEVEL_CLEARED,
+    SIM_GAME_OVER
+} SimStatus;
+
+// Game options, set before StartGame and kept across games
+typedef struct SimConfig {
+    uint64_t seed;            // Seeds the gameplay stream; the same seed and inputs replay the same game
+    BoardLayout customBoard;  // Used for every level when cols > 0 (stress boards)
+    bool massiveMultiball;    // Up to MASSIVE_MAX_BALLS; MULTIBALL doubles the balls in play
+    int startBalls;           // Balls launched at the start of a level (0 = 1)
+    int blastRadius;          // Explosive brick reach (0 = BLAST_RADIUS)
+    int chainBudget;          // Blasts resolved per tick (0 = CHAIN_BLASTS_PER_TICK)
+} SimConfig;
+
+// Complete gameplay state. Zero-initialise it before the first StartGame and release
+// it with FreeSimState.
+typedef struct SimState {
+    SimConfig config;
+
+    SimStatus status;
+    int level;
+    int score;
+    int lives;
+    uint64_t tick;  // Ticks simulated since the game started
+    Rng rng;        // Gameplay stream (RNG_STREAM_GAMEPLAY) of config.seed
+
+    SimRect paddle;
+    float paddleBuffTimer;
+
+    Ball *balls;       // Heap storage for ballLimit balls
+    int ballCount;
+    int ballLimit;     // MAX_BALLS, or MASSIVE_MAX_BALLS in massive-multiball mode
+    PowerUp powerups[MAX_POWERUPS];
+    BrickField bricks;
+
+    // Combo system
+    int brickCombo;
+    float comboMultiplier;
+
+    // Level statistics
+    float levelTimer;
+    int bricksSmashed;
+    float levelCompletionTime;
+    int timeBonus;  // Bonus awarded when the level was cleared
+} SimState;
+
+// Where a ball is predicted to reach the paddle's line
+typedef struct BallLanding {
+    float x;      // Ball centre when it gets there
+    float time;   // Seconds from now
+    int bounces;  // Wall and brick reflections on the way
+} BallLanding;
+
+// Board layouts
+BoardLayout GetLevelLayout(int level);  // The regular board for a level
+BoardLayout MakeFittedLayout(int cols, int rows);  // cols x rows bricks squeezed into the regular board's area
+
+// Brick field access
+bool ResizeBrickField(BrickField *field, const BoardLayout *layout);  // Clears; false if out of memory
+void FreeBrickField(BrickField *field);
+void ClearBrickField(BrickField *field);
+bool IsBrickActive(const BrickField *field, int index);
+bool IsBrickDiscovered(const BrickField *field, int index);
+void SetBrickDiscovered(BrickField *field, int index, bool discovered);
+void ActivateBrick(BrickField *field, int index);
+void DestroyBrick(BrickField *field, int index);
+SimRect GetBrickRect(const BrickField *field, int index);
+
+// Game flow
+bool StartGame(SimState *sim);                 // New game from level 1 with sim->config; false if out of memory
+bool LoadLevel(SimState *sim, int level);      // Fresh board, balls, paddle and power-ups; false if out of memory
+void FreeSimState(SimState *sim);
+void StepSimulation(SimState *sim, SimInput input, SimEventList *events);  // Advance one SIM_DT tick
+void FreeSimEventList(SimEventList *events);
+uint64_t HashSimState(const SimState *sim);  // Fingerprint of the gameplay state, for replay divergence checks
+// Trace a ball's path off the walls and live bricks to the paddle's line, within
+// maxTime seconds. Bricks count as solid for the whole path (breaking is not modelled).
+bool PredictBallLanding(const SimState *sim, const Ball *ball, float maxTime, BallLanding *landing);
+
+#endif // SMASH_SIM_H
@@ -0,0 +1,446 @@
+#include <stdlib.h>
+#include <string.h>
+#include "smash_snapshot.h"
+
+#define MIN_ZERO_RUN 4  // Shorter unchanged gaps stay inside a literal run
+
+static size_t GetMaskBytes(int count) {
+    return (size_t)(count + 31) / 32 * sizeof(uint32_t);
+}
+
+// SimState fields stored in an image header, one after another with no padding. The
+// heap arrays follow the header; powerups are stored element by element.
+#define HEADER_FIELDS(X) \
+    X(config.seed) X(config.customBoard) X(config.massiveMultiball) X(config.startBalls) \
+    X(config.blastRadius) X(config.chainBudget) \
+    X(status) X(level) X(score) X(lives) X(tick) X(rng) \
+    X(paddle) X(paddleBuffTimer) X(ballCount) X(ballLimit) \
+    X(bricks.layout) X(bricks.activeCount) X(bricks.blastCount) \
+    X(brickCombo) X(comboMultiplier) X(levelTimer) X(bricksSmashed) X(levelCompletionTime) X(timeBonus)
+
+#define FIELD_SIZE(field) + sizeof(((SimState *)0)->field)
+#define HEADER_BYTES (0 HEADER_FIELDS(FIELD_SIZE) + \
+                      MAX_POWERUPS * (sizeof(SimRect) + sizeof(PowerUpType) + sizeof(bool)))
+
+static uint8_t *PutBytes(uint8_t *at, const void *data, size_t bytes) {
+    memcpy(at, data, bytes);
+    return at + bytes;
+}
+
+static const uint8_t *GetBytes(const uint8_t *at, void *data, size_t bytes) {
+    memcpy(data, at, bytes);
+    return at + bytes;
+}
+
+static uint8_t *WriteHeader(const SimState *sim, uint8_t *at) {
+#define PUT_FIELD(field) at = PutBytes(at, &sim->field, sizeof(sim->field));
+    HEADER_FIELDS(PUT_FIELD)
+#undef PUT_FIELD
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        at = PutBytes(at, &sim->powerups[i].rect, sizeof(SimRect));
+        at = PutBytes(at, &sim->powerups[i].type, sizeof(PowerUpType));
+        at = PutBytes(at, &sim->powerups[i].active, sizeof(bool));
+    }
+    return at;
+}
+
+static const uint8_t *ReadHeader(const uint8_t *at, SimState *sim) {
+#define GET_FIELD(field) at = GetBytes(at, &sim->field, sizeof(sim->field));
+    HEADER_FIELDS(GET_FIELD)
+#undef GET_FIELD
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        at = GetBytes(at, &sim->powerups[i].rect, sizeof(SimRect));
+        at = GetBytes(at, &sim->powerups[i].type, sizeof(PowerUpType));
+        at = GetBytes(at, &sim->powerups[i].active, sizeof(bool));
+    }
+    return at;
+}
+
+// Image layout: the header, activeMask, discoveredMask, type, health, balls[0, ballCount),
+// then the live blast queue from its head. Variable-length parts go last so a ball
+// being added or lost doesn't shift the brick arrays and spoil the next delta.
+static size_t GetImageSize(const SimState *sim) {
+    int count = sim->bricks.layout.cols * sim->bricks.layout.rows;
+    return HEADER_BYTES + 2 * GetMaskBytes(count) + 2 * (size_t)count +
+           (size_t)sim->ballCount * sizeof(Ball) + (size_t)sim->bricks.blastCount * sizeof(int);
+}
+
+static bool ReserveImage(SimSnapshot *snapshot, size_t bytes) {
+    if (bytes > snapshot->capacity) {
+        uint8_t *image = realloc(snapshot->image, bytes);
+        if (image == NULL) return false;
+        snapshot->image = image;
+        snapshot->capacity = bytes;
+    }
+    snapshot->imageBytes = bytes;
+    return true;
+}
+
+static void WriteImage(const SimState *sim, uint8_t *image) {
+    const BrickField *bricks = &sim->bricks;
+    size_t maskBytes = GetMaskBytes(bricks->count);
+    size_t count = (size_t)bricks->count;
+
+    uint8_t *at = WriteHeader(sim, image);
+    at = PutBytes(at, bricks->activeMask, maskBytes);
+    at = PutBytes(at, bricks->discoveredMask, maskBytes);
+    at = PutBytes(at, bricks->type, count);
+    at = PutBytes(at, bricks->health, count);
+    at = PutBytes(at, sim->balls, (size_t)sim->ballCount * sizeof(Ball));
+    for (int i = 0; i < bricks->blastCount; i++) {
+        at = PutBytes(at, &bricks->blastQueue[(bricks->blastHead + i) % bricks->count], sizeof(int));
+    }
+}
+
+// Rebuild sim from an image, reusing its heap storage
+static bool ReadImage(const uint8_t *image, size_t imageBytes, SimState *sim) {
+    SimState header = { 0 };
+    if (imageBytes < HEADER_BYTES) return false;
+    const uint8_t *at = ReadHeader(image, &header);
+    const BoardLayout *layout = &header.bricks.layout;
+    if (layout->cols < 0 || layout->rows < 0 || header.ballCount < 0 || header.ballCount > header.ballLimit ||
+        header.bricks.blastCount < 0 || header.bricks.blastCount > layout->cols * layout->rows ||
+        GetImageSize(&header) != imageBytes) return false;
+
+    if (sim->balls == NULL || sim->ballLimit != header.ballLimit) {
+        Ball *balls = realloc(sim->balls, (size_t)header.ballLimit * sizeof(Ball));
+        if (balls == NULL) return false;
+        sim->balls = balls;
+        sim->ballLimit = header.ballLimit;
+    }
+    // Clearing also marks every brick changed, as the arrays are overwritten below
+    if (!ResizeBrickField(&sim->bricks, layout)) return false;
+
+    Ball *balls = sim->balls;
+    BrickField bricks = sim->bricks;
+    bricks.activeCount = header.bricks.activeCount;
+    bricks.blastHead = 0;
+    bricks.blastCount = header.bricks.blastCount;
+    *sim = header;
+    sim->balls = balls;
+    sim->bricks = bricks;
+
+    size_t maskBytes = GetMaskBytes(bricks.count);
+    size_t count = (size_t)bricks.count;
+    at = GetBytes(at, bricks.activeMask, maskBytes);
+    at = GetBytes(at, bricks.discoveredMask, maskBytes);
+    at = GetBytes(at, bricks.type, count);
+    at = GetBytes(at, bricks.health, count);
+    at = GetBytes(at, balls, (size_t)sim->ballCount * sizeof(Ball));
+    GetBytes(at, bricks.blastQueue, (size_t)bricks.blastCount * sizeof(int));
+    return true;
+}
+
+bool SaveSimSnapshot(SimSnapshot *snapshot, const SimState *sim) {
+    if (!ReserveImage(snapshot, GetImageSize(sim))) return false;
+    WriteImage(sim, snapshot->image);
+    return true;
+}
+
+bool LoadSimSnapshot(const SimSnapshot *snapshot, SimState *sim) {
+    if (snapshot->imageBytes == 0) return false;
+    return ReadImage(snapshot->image, snapshot->imageBytes, sim);
+}
+
+void FreeSimSnapshot(SimSnapshot *snapshot) {
+    free(snapshot->image);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+// Delta records: tokens of (varint zero run, varint literal length, literal XOR bytes).
+// Bytes after the last token are unchanged, and the base is treated as zero past its end.
+
+static uint8_t *PutVarint(uint8_t *at, size_t value) {
+    while (value >= 0x80) {
+        *at++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *at++ = (uint8_t)value;
+    return at;
+}
+
+static bool GetVarint(const uint8_t **at, const uint8_t *end, size_t *value) {
+    *value = 0;
+    for (int shift = 0; *at < end && shift < 64; shift += 7) {
+        uint8_t byte = *(*at)++;
+        *value |= (size_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint8_t GetBaseByte(const SimSnapshot *base, size_t i) {
+    return (i < base->imageBytes) ? base->image[i] : 0;
+}
+
+// Length of the unchanged run from i up to end, compared a word at a time where it can
+static size_t GetZeroRun(const SimSnapshot *image, const SimSnapshot *base, size_t i, size_t end) {
+    size_t start = i;
+    size_t shared = (end < base->imageBytes) ? end : base->imageBytes;
+    while (i + sizeof(uint64_t) <= shared) {
+        uint64_t a, b;
+        memcpy(&a, image->image + i, sizeof(a));
+        memcpy(&b, base->image + i, sizeof(b));
+        if (a != b) break;
+        i += sizeof(uint64_t);
+    }
+    while (i < end && image->image[i] == GetBaseByte(base, i)) i++;
+    return i - start;
+}
+
+// Diffs only the given ranges (in order, not overlapping, within the image); the bytes
+// between them are known to match the base. Returns the encoded size, or 0 when the
+// delta would be larger than limit.
+static size_t EncodeDelta(const SimSnapshot *image, const SimSnapshot *base, const SnapshotRange *ranges, int rangeCount,
+                          uint8_t *out, size_t limit) {
+    uint8_t *at = out;
+    size_t zeros = 0;
+    size_t done = 0;
+    for (int r = 0; r < rangeCount; r++) {
+        size_t end = ranges[r].end;
+        size_t i = ranges[r].start;
+        zeros += i - done;
+        while (i < end) {
+            size_t run = GetZeroRun(image, base, i, end);
+            zeros += run;
+            i += run;
+            if (i == end) break;
+
+            size_t literalEnd = i;
+            while (literalEnd < end) {
+                size_t gap = GetZeroRun(image, base, literalEnd, end);
+                if (gap >= MIN_ZERO_RUN || literalEnd + gap == end) break;
+                literalEnd += gap + 1;
+            }
+            size_t literal = literalEnd - i;
+            if ((size_t)(at - out) + 20 + literal > limit) return 0;
+
+            at = PutVarint(at, zeros);
+            at = PutVarint(at, literal);
+            for (size_t j = i; j < literalEnd; j++) *at++ = image->image[j] ^ GetBaseByte(base, j);
+            zeros = 0;
+            i = literalEnd;
+        }
+        done = end;
+    }
+    if (at == out) {
+        // Nothing changed, but a size of 0 means too large
+        at = PutVarint(at, 0);
+        at = PutVarint(at, 0);
+    }
+    return (size_t)(at - out);
+}
+
+// XOR a delta record into image, which already holds the base resized to the new size
+static bool ApplyDelta(const uint8_t *record, size_t recordBytes, SimSnapshot *image) {
+    const uint8_t *at = record;
+    const uint8_t *end = record + recordBytes;
+    size_t i = 0;
+    while (at < end) {
+        size_t zeros, literal;
+        if (!GetVarint(&at, end, &zeros) || !GetVarint(&at, end, &literal)) return false;
+        i += zeros;
+        if (literal > (size_t)(end - at) || i + literal > image->imageBytes) return false;
+        for (size_t j = 0; j < literal; j++) image->image[i + j] ^= at[j];
+        at += literal;
+        i += literal;
+    }
+    return true;
+}
+
+bool InitSnapshotRing(SnapshotRing *ring, size_t arenaBytes, int maxRecords, int keyframeInterval) {
+    memset(ring, 0, sizeof(*ring));
+    ring->arena = malloc(arenaBytes);
+    ring->records = malloc((size_t)maxRecords * sizeof(SnapshotRecord));
+    if (ring->arena == NULL || ring->records == NULL) {
+        FreeSnapshotRing(ring);
+        return false;
+    }
+    ring->arenaBytes = arenaBytes;
+    ring->recordCapacity = maxRecords;
+    ring->keyframeInterval = (keyframeInterval > 0) ? keyframeInterval : 1;
+    return true;
+}
+
+void FreeSnapshotRing(SnapshotRing *ring) {
+    free(ring->arena);
+    free(ring->records);
+    free(ring->encoded);
+    free(ring->ranges);
+    FreeSimSnapshot(&ring->base);
+    FreeSimSnapshot(&ring->work);
+    memset(ring, 0, sizeof(*ring));
+}
+
+void ClearSnapshotRing(SnapshotRing *ring) {
+    ring->arenaHead = 0;
+    ring->first = 0;
+    ring->count = 0;
+    ring->sinceKeyframe = 0;
+    ring->base.imageBytes = 0;
+}
+
+static SnapshotRecord *GetRecord(SnapshotRing *ring, int index) {
+    return &ring->records[(ring->first + index) % ring->recordCapacity];
+}
+
+static void DropOldest(SnapshotRing *ring) {
+    ring->first = (ring->first + 1) % ring->recordCapacity;
+    ring->count--;
+}
+
+// Find room for a record of the given size, evicting the oldest records in its way
+static bool PlaceRecord(SnapshotRing *ring, size_t bytes, size_t *offset) {
+    if (bytes > ring->arenaBytes) return false;
+    if (ring->count == ring->recordCapacity) DropOldest(ring);
+
+    size_t start = ring->arenaHead;
+    if (start + bytes > ring->arenaBytes) {
+        // Wrap: records between the head and the end of the arena are the oldest ones
+        while (ring->count > 0 && GetRecord(ring, 0)->offset >= start) DropOldest(ring);
+        start = 0;
+    }
+    while (ring->count > 0) {
+        const SnapshotRecord *oldest = GetRecord(ring, 0);
+        if (oldest->offset >= start + bytes || oldest->offset + oldest->recordBytes <= start) break;
+        DropOldest(ring);
+    }
+    // Deltas are useless without the keyframe they build on
+    while (ring->count > 0 && !GetRecord(ring, 0)->keyframe) DropOldest(ring);
+
+    *offset = start;
+    return true;
+}
+
+static void AddRange(SnapshotRing *ring, size_t start, size_t end) {
+    if (ring->rangeCount > 0 && ring->ranges[ring->rangeCount - 1].end == start) {
+        ring->ranges[ring->rangeCount - 1].end = end;
+    } else {
+        ring->ranges[ring->rangeCount++] = (SnapshotRange){ start, end };
+    }
+}
+
+// The parts of the new image that can differ from the base: the header, the brick words
+// the sim has stamped since the base was captured, and the balls and blast queue. The
+// whole image when the base is missing or has another brick count.
+static bool FindChangedRanges(SnapshotRing *ring, const SimState *sim, size_t imageBytes) {
+    const BrickField *bricks = &sim->bricks;
+    int words = (bricks->count + 31) / 32;
+    if (ring->rangeCapacity < 4 * words + 2) {
+        SnapshotRange *ranges = realloc(ring->ranges, (size_t)(4 * words + 2) * sizeof(SnapshotRange));
+        if (ranges == NULL) return false;
+        ring->ranges = ranges;
+        ring->rangeCapacity = 4 * words + 2;
+    }
+    ring->rangeCount = 0;
+    if (ring->base.imageBytes == 0 || ring->baseBricks != bricks->count || bricks->stamp < ring->baseStamp) {
+        AddRange(ring, 0, imageBytes);
+        return true;
+    }
+
+    size_t maskBytes = GetMaskBytes(bricks->count);
+    size_t count = (size_t)bricks->count;
+    size_t typeStart = HEADER_BYTES + 2 * maskBytes;
+    size_t healthStart = typeStart + count;
+    AddRange(ring, 0, HEADER_BYTES);
+    for (int mask = 0; mask < 2; mask++) {
+        size_t maskStart = HEADER_BYTES + mask * maskBytes;
+        for (int w = 0; w < words; w++) {
+            if (bricks->wordStamp[w] < ring->baseStamp) continue;
+            AddRange(ring, maskStart + w * sizeof(uint32_t), maskStart + (w + 1) * sizeof(uint32_t));
+        }
+    }
+    for (size_t arrayStart = typeStart; arrayStart <= healthStart; arrayStart += count) {
+        for (int w = 0; w < words; w++) {
+            if (bricks->wordStamp[w] < ring->baseStamp) continue;
+            size_t end = (size_t)(w + 1) * 32;
+            AddRange(ring, arrayStart + (size_t)w * 32, arrayStart + ((end < count) ? end : count));
+        }
+    }
+    AddRange(ring, healthStart + count, imageBytes);
+    return true;
+}
+
+bool CaptureSnapshot(SnapshotRing *ring, const SimState *sim) {
+    if (!SaveSimSnapshot(&ring->work, sim)) return false;
+    size_t imageBytes = ring->work.imageBytes;
+
+    bool keyframe = ring->count == 0 || ring->sinceKeyframe + 1 >= ring->keyframeInterval;
+    size_t recordBytes = imageBytes;
+    if (!keyframe) {
+        if (ring->encodedCapacity < imageBytes) {
+            uint8_t *encoded = realloc(ring->encoded, imageBytes);
+            if (encoded == NULL) return false;
+            ring->encoded = encoded;
+            ring->encodedCapacity = imageBytes;
+        }
+        if (!FindChangedRanges(ring, sim, imageBytes)) return false;
+        recordBytes = EncodeDelta(&ring->work, &ring->base, ring->ranges, ring->rangeCount, ring->encoded, imageBytes);
+        if (recordBytes == 0) {
+            keyframe = true;
+            recordBytes = imageBytes;
+        }
+    }
+
+    size_t offset;
+    if (!PlaceRecord(ring, recordBytes, &offset)) return false;
+    if (!keyframe && ring->count == 0) {
+        // Eviction took the delta's base with it
+        keyframe = true;
+        recordBytes = imageBytes;
+        if (!PlaceRecord(ring, recordBytes, &offset)) return false;
+    }
+    memcpy(ring->arena + offset, keyframe ? ring->work.image : ring->encoded, recordBytes);
+
+    SnapshotRecord *record = GetRecord(ring, ring->count++);
+    record->tick = sim->tick;
+    record->offset = offset;
+    record->recordBytes = (uint32_t)recordBytes;
+    record->imageBytes = (uint32_t)imageBytes;
+    record->keyframe = keyframe;
+    ring->arenaHead = offset + recordBytes;
+    ring->sinceKeyframe = keyframe ? 0 : ring->sinceKeyframe + 1;
+
+    SimSnapshot swap = ring->base;
+    ring->base = ring->work;
+    ring->work = swap;
+    ring->baseStamp = sim->bricks.stamp;
+    ring->baseBricks = sim->bricks.count;
+    return true;
+}
+
+bool RestoreSnapshot(SnapshotRing *ring, int back, SimState *sim) {
+    if (back < 0 || back >= ring->count) return false;
+    int target = ring->count - 1 - back;
+    int keyframe = target;
+    while (!GetRecord(ring, keyframe)->keyframe) keyframe--;
+
+    // Start from the keyframe and apply the deltas after it in order
+    SimSnapshot *image = &ring->work;
+    for (int i = keyframe; i <= target; i++) {
+        const SnapshotRecord *record = GetRecord(ring, i);
+        const uint8_t *bytes = ring->arena + record->offset;
+        if (record->keyframe) {
+            if (!ReserveImage(image, record->imageBytes)) return false;
+            memcpy(image->image, bytes, record->imageBytes);
+            continue;
+        }
+        size_t previousBytes = image->imageBytes;
+        if (!ReserveImage(image, record->imageBytes)) return false;
+        if (record->imageBytes > previousBytes) memset(image->image + previousBytes, 0, record->imageBytes - previousBytes);
+        if (!ApplyDelta(bytes, record->recordBytes, image)) return false;
+    }
+    if (!ReadImage(image->image, image->imageBytes, sim)) return false;
+
+    // The restored state becomes the newest record and the base for the next delta
+    const SnapshotRecord *restored = GetRecord(ring, target);
+    ring->count = target + 1;
+    ring->arenaHead = restored->offset + restored->recordBytes;
+    ring->sinceKeyframe = target - keyframe;
+    SimSnapshot swap = ring->base;
+    ring->base = ring->work;
+    ring->work = swap;
+    ring->baseStamp = sim->bricks.stamp;
+    ring->baseBricks = sim->bricks.count;
+    return true;
+}
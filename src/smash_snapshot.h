@@ -0,0 +1,65 @@
+// Smash Out! state snapshots: single SimState images for restarts, and a fixed-size
+// ring of XOR-delta records for rewinding. Pure C99 with no raylib dependency.
+
+#ifndef SMASH_SNAPSHOT_H
+#define SMASH_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "smash_sim.h"
+
+typedef struct SimSnapshot {
+    uint8_t *image;
+    size_t imageBytes;
+    size_t capacity;
+} SimSnapshot;
+
+bool SaveSimSnapshot(SimSnapshot *snapshot, const SimState *sim);  // false if out of memory
+bool LoadSimSnapshot(const SimSnapshot *snapshot, SimState *sim);  // false if empty or out of memory
+void FreeSimSnapshot(SimSnapshot *snapshot);
+
+typedef struct SnapshotRecord {
+    uint64_t tick;         // sim->tick when it was captured
+    size_t offset;         // Position in the arena
+    uint32_t recordBytes;  // Stored size
+    uint32_t imageBytes;   // Decoded size
+    bool keyframe;         // Whole image rather than an XOR delta
+} SnapshotRecord;
+
+typedef struct SnapshotRange {
+    size_t start;
+    size_t end;
+} SnapshotRange;
+
+typedef struct SnapshotRing {
+    uint8_t *arena;        // Record bytes, written in order and wrapped at the end
+    size_t arenaBytes;
+    size_t arenaHead;      // Where the next record goes
+    SnapshotRecord *records;  // Ring of record descriptors, oldest at first
+    int recordCapacity;
+    int first;
+    int count;
+    int keyframeInterval;
+    int sinceKeyframe;     // Deltas captured since the last keyframe
+
+    SimSnapshot base;      // Latest captured image: the next delta is taken against it
+    SimSnapshot work;      // Image being captured or rebuilt
+    uint32_t baseStamp;    // sim->bricks.stamp when the base was captured
+    int baseBricks;        // Brick count of the base
+    uint8_t *encoded;      // Delta being encoded
+    size_t encodedCapacity;
+    SnapshotRange *ranges;  // Parts of the image the delta diffs
+    int rangeCount;
+    int rangeCapacity;
+} SnapshotRing;
+
+bool InitSnapshotRing(SnapshotRing *ring, size_t arenaBytes, int maxRecords, int keyframeInterval);
+void FreeSnapshotRing(SnapshotRing *ring);
+void ClearSnapshotRing(SnapshotRing *ring);
+bool CaptureSnapshot(SnapshotRing *ring, const SimState *sim);  // false if the state doesn't fit the arena
+// Restore the record `back` captures before the newest (0 = newest) and drop the newer
+// ones, so capturing carries on from there. False if the ring doesn't reach that far.
+bool RestoreSnapshot(SnapshotRing *ring, int back, SimState *sim);
+
+#endif // SMASH_SNAPSHOT_H